@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "engine.h"
+
+using namespace std;
+
+// Search benchmark: runs BotManager::makeMove on a fixed set of random
+// positions and reports nodes, time, a checksum of the chosen moves (to spot
+// behaviour changes) and heap allocations made while searching, which must
+// be zero. Exits with 1 if the search allocated.
+// Usage: bench [--positions N] [--depth N] [--seed N] [--pruning all|none|lmr,null,futility] [--win K]
+
+// Count every heap allocation made by the process
+static atomic<long long> allocationCount(0);
+
+void *operator new(size_t size) {
+    allocationCount++;
+    if (void *p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// Scatter stones of both colours around the center without making k in a row
+void makePosition(Grid &grid, mt19937 &rng) {
+    GameLogic gameLogic(grid);
+    int stones = 4 + rng() % 12;
+    char player = 'O';
+    uniform_int_distribution<int> offset(-3, 3);
+
+    for (int placed = 0; placed < stones;) {
+        int row = grid.getRows() / 2 + offset(rng);
+        int col = grid.getCols() / 2 + offset(rng);
+        if (!grid.isCellEmpty(row, col)) continue;
+        grid.makeMove(row, col, player);
+        if (gameLogic.checkWinner(row, col).hasWinner) {
+            grid.unmakeMove();
+            continue;
+        }
+        player = (player == 'O') ? 'X' : 'O';
+        placed++;
+    }
+}
+
+int main(int argc, char **argv) {
+    int positions = 20, depth = 3, winLength = DEFAULT_WIN_LENGTH;
+    unsigned seed = 1;
+    unsigned pruning = BotManager::PRUNE_ALL;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i], value = argv[i + 1];
+        if (arg == "--positions") positions = stoi(value);
+        else if (arg == "--depth") depth = stoi(value);
+        else if (arg == "--seed") seed = stoul(value);
+        else if (arg == "--win") winLength = max(MIN_WIN_LENGTH, min(MAX_WIN_LENGTH, stoi(value)));
+        else if (arg == "--pruning") {
+            pruning = BotManager::PRUNE_NONE;
+            if (value == "all") pruning = BotManager::PRUNE_ALL;
+            if (value.find("lmr") != string::npos) pruning |= BotManager::PRUNE_LMR;
+            if (value.find("null") != string::npos) pruning |= BotManager::PRUNE_NULL_MOVE;
+            if (value.find("futility") != string::npos) pruning |= BotManager::PRUNE_FUTILITY;
+        }
+    }
+
+    const int sizes[][2] = {{10, 10}, {15, 15}, {19, 19}};
+    bool allocated = false;
+
+    for (auto &size : sizes) {
+        mt19937 rng(seed);
+        long long nodes = 0, allocations = 0;
+        unsigned long long checksum = 0;
+        double seconds = 0;
+
+        for (int p = 0; p < positions; ++p) {
+            Grid grid(size[0], size[1], winLength);
+            makePosition(grid, rng);
+            BotManager bot(grid, 'X');
+            bot.setSearchDepth(depth);
+            bot.setVerbose(false);
+            bot.setPruning(pruning);
+            bot.reserveContext(); // The first search on a board size would grow the thread's context
+
+            long long before = allocationCount;
+            auto start = chrono::steady_clock::now();
+            bot.makeMove();
+            seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            allocations += allocationCount - before;
+
+            nodes += bot.getLastNodes();
+            checksum = checksum * 31 + bot.getLastRow() * size[1] + bot.getLastCol();
+        }
+
+        cout << size[0] << "x" << size[1] << (winLength != DEFAULT_WIN_LENGTH ? ", k=" + to_string(winLength) : "") << ": " << nodes << " nodes in " << seconds << " s ("
+             << (long long)(nodes / max(seconds, 1e-9)) << " nodes/s), allocations " << allocations
+             << ", checksum " << checksum << endl;
+        if (allocations > 0) allocated = true;
+    }
+
+    if (allocated) cout << "FAIL: the search allocated memory" << endl;
+    return allocated ? 1 : 0;
+}
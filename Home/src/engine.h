@@ -0,0 +1,1655 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+// Game engine shared by the GUI (finalProject.cpp) and the headless tools.
+// Nothing in here may depend on graphics.h.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "solver.h"
+#include "symmetry.h"
+
+// Win length k of an m,n,k game: k stones of one symbol in a row win
+constexpr int DEFAULT_WIN_LENGTH = 5;
+constexpr int MIN_WIN_LENGTH = 3;
+constexpr int MAX_WIN_LENGTH = 8; // Longest k the line tables have room for
+
+// Class to manage the grid
+// Cells are stored row by row in one block, either owned by the Grid or
+// provided by the caller (see SlabAllocator in slab.h). Moves made with
+// makeMove() go on an undo stack, and the empty-cell count and the Zobrist
+// hash keys are kept up to date on every change: one for the grid and one
+// for each of its symmetric images (see symmetry.h), whose minimum keys the
+// position up to symmetry. The grid also carries the win length of the game
+// played on it.
+class Grid {
+private:
+    int rows, cols;
+    int winLength;
+    int symmetries;
+    std::vector<char> storage; // Empty when the grid lives in external memory
+    int *undoStack;            // Cell index of every move made with makeMove()
+    char *cells;
+    int moveCount;
+    int emptyCount;
+    uint64_t imageHash[MAX_SYMMETRIES]; // imageHash[0] is the grid's own key
+
+    // Point undoStack and cells into a block of storageSize() bytes
+    void attach(char *block) {
+        undoStack = reinterpret_cast<int *>(block);
+        cells = block + sizeof(int) * rows * cols;
+    }
+
+    // Toggle symbol on index in every image's key
+    void hashStone(int index, char symbol) {
+        int row = index / cols, col = index % cols;
+        for (int t = 0; t < symmetries; ++t) imageHash[t] ^= zobristKey(transformRowCol(rows, cols, t, row, col), symbol);
+    }
+
+    void place(int index, char symbol) {
+        char old = cells[index];
+        if (old != ' ') {
+            hashStone(index, old);
+            emptyCount++;
+        }
+        if (symbol != ' ') {
+            hashStone(index, symbol);
+            emptyCount--;
+        }
+        cells[index] = symbol;
+    }
+
+public:
+    Grid(int n, int m, int k = DEFAULT_WIN_LENGTH)
+        : rows(n), cols(m), winLength(k), symmetries(symmetryCount(n, m)), storage(storageSize(n, m)) {
+        assert(k <= MAX_WIN_LENGTH); // Longer lines overflow LineSpan
+        attach(storage.data());
+        clearGrid();
+    }
+
+    // Use caller-provided memory of storageSize(n, m) bytes, aligned for int
+    Grid(int n, int m, int k, char *external) : rows(n), cols(m), winLength(k), symmetries(symmetryCount(n, m)) {
+        assert(k <= MAX_WIN_LENGTH);
+        attach(external);
+        clearGrid();
+    }
+
+    Grid(const Grid &other)
+        : rows(other.rows), cols(other.cols), winLength(other.winLength), symmetries(other.symmetries),
+          storage(storageSize(other.rows, other.cols)), moveCount(other.moveCount), emptyCount(other.emptyCount) {
+        attach(storage.data());
+        std::copy(other.imageHash, other.imageHash + MAX_SYMMETRIES, imageHash);
+        std::copy(other.undoStack, other.undoStack + moveCount, undoStack);
+        std::copy(other.cells, other.cells + rows * cols, cells);
+    }
+
+    Grid &operator=(const Grid &) = delete;
+
+    // Bytes needed for the undo stack and cells of an n x m grid
+    static size_t storageSize(int n, int m) { return (sizeof(int) + 1) * (size_t)n * m; }
+
+    // Random key of a symbol on a cell, mixed from the cell index (splitmix64)
+    static uint64_t zobristKey(int index, char symbol) {
+        uint64_t x = (uint64_t)index * 2 + (symbol == 'X') + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    void clearGrid() {
+        std::fill(cells, cells + rows * cols, ' '); // Reset each cell to ' '
+        moveCount = 0;
+        emptyCount = rows * cols;
+        std::fill(imageHash, imageHash + MAX_SYMMETRIES, 0);
+    }
+
+    bool isCellEmpty(int row, int col) {
+        return cells[row * cols + col] == ' ';
+    }
+
+    // Change a cell without recording it on the undo stack
+    void setCell(int row, int col, char symbol) {
+        place(row * cols + col, symbol);
+    }
+
+    char getCell(int row, int col) {
+        return cells[row * cols + col];
+    }
+
+    // Row-major cell array, for loops that compute flat indices themselves
+    const char *getCells() const { return cells; }
+
+    // The undo stack and cells as one block of storageSize() bytes, for snapshots
+    const char *getStorage() const { return reinterpret_cast<const char *>(undoStack); }
+
+    // Whether block holds a grid that restore() can load: only ' ', 'O' and
+    // 'X' in the cells, and moves distinct occupied cells on the undo stack,
+    // one for each stone
+    static bool isValidStorage(const char *block, int n, int m, int moves) {
+        int cellCount = n * m;
+        if (moves < 0 || moves > cellCount) return false;
+        const char *blockCells = block + sizeof(int) * cellCount;
+        int stones = 0;
+        for (int i = 0; i < cellCount; ++i) {
+            char c = blockCells[i];
+            if (c != ' ' && c != 'O' && c != 'X') return false;
+            if (c != ' ') stones++;
+        }
+        if (stones != moves) return false;
+        std::vector<bool> seen(cellCount, false);
+        for (int i = 0; i < moves; ++i) {
+            int index;
+            std::memcpy(&index, block + sizeof(int) * i, sizeof(int));
+            if (index < 0 || index >= cellCount || blockCells[index] == ' ' || seen[index]) return false;
+            seen[index] = true;
+        }
+        return true;
+    }
+
+    // Load a block taken from getStorage() of a grid of the same size with
+    // moves moves on its undo stack; the counts and hash are recomputed.
+    // Check untrusted blocks with isValidStorage() first.
+    void restore(const char *block, int moves) {
+        std::copy(block, block + storageSize(rows, cols), reinterpret_cast<char *>(undoStack));
+        moveCount = moves;
+        emptyCount = rows * cols;
+        std::fill(imageHash, imageHash + MAX_SYMMETRIES, 0);
+        for (int i = 0; i < rows * cols; ++i) {
+            if (cells[i] != ' ') {
+                emptyCount--;
+                hashStone(i, cells[i]);
+            }
+        }
+    }
+
+    // Place a symbol on an empty cell; undone by unmakeMove()
+    void makeMove(int row, int col, char symbol) {
+        int index = row * cols + col;
+        place(index, symbol);
+        undoStack[moveCount++] = index;
+    }
+
+    // Take back the last move made with makeMove()
+    void unmakeMove() {
+        place(undoStack[--moveCount], ' ');
+    }
+
+    // Moves on the undo stack, oldest first
+    int getMoveCount() { return moveCount; }
+    int getMoveRow(int i) { return undoStack[i] / cols; }
+    int getMoveCol(int i) { return undoStack[i] % cols; }
+
+    int getRows() { return rows; }
+    int getCols() { return cols; }
+    int getWinLength() { return winLength; }
+    int countEmptyCells() { return emptyCount; }
+    uint64_t getHash() { return imageHash[0]; }
+
+    // The symmetry taking the grid to its canonical image, the one with the
+    // smallest key; positions that are images of each other share it
+    int getCanonicalSymmetry() {
+        int best = 0;
+        for (int t = 1; t < symmetries; ++t) {
+            if (imageHash[t] < imageHash[best]) best = t;
+        }
+        return best;
+    }
+
+    uint64_t getCanonicalHash() { return imageHash[getCanonicalSymmetry()]; }
+    uint64_t getImageHash(int symmetry) { return imageHash[symmetry]; }
+
+    // Map a cell index into the canonical image and back
+    int toCanonical(int symmetry, int index) { return transformCell(rows, cols, symmetry, index); }
+    int fromCanonical(int symmetry, int index) { return transformCell(rows, cols, inverseSymmetry(rows, cols, symmetry), index); }
+
+    bool isFull() {
+        return emptyCount == 0;
+    }
+};
+
+// Class to manage players
+class PlayerManager {
+private:
+    char currentPlayer;
+
+public:
+    PlayerManager() : currentPlayer('O') {}
+
+    char getCurrentPlayer() {
+        return currentPlayer;
+    }
+
+    void switchPlayer() {
+        currentPlayer = (currentPlayer == 'O') ? 'X' : 'O';
+    }
+
+    void setCurrentPlayer(char player) { currentPlayer = player; }
+};
+
+struct WinSequence {
+    bool hasWinner;
+    int startRow, startCol;
+    int endRow, endCol;
+};
+
+// Directions of the lines through a cell: horizontal, vertical, diagonal, anti-diagonal
+constexpr int LINE_DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+constexpr int LINE_REACH = MAX_WIN_LENGTH - 1; // Most cells on each side of a cell that share a k-cell window with it
+
+// The cells within k - 1 of a cell along one direction, as flat indices,
+// nearest first and clipped at the edge of the board. Every k-cell window
+// through the cell is k consecutive cells of before (reversed), the cell
+// itself and after. Indices are 16-bit, which covers every board the GUI
+// and the server allow.
+struct LineSpan {
+    int16_t after[LINE_REACH];
+    int16_t before[LINE_REACH];
+    int8_t afterCount, beforeCount;
+};
+
+// Line spans of one cell in all four directions
+struct LineCell {
+    LineSpan dir[4];
+};
+
+constexpr LineSpan makeLineSpan(int rows, int cols, int reach, int row, int col, int rowDir, int colDir) {
+    LineSpan span = {};
+    for (int i = 1; i <= reach; ++i) {
+        int newRow = row + i * rowDir, newCol = col + i * colDir;
+        if (newRow < 0 || newRow >= rows || newCol < 0 || newCol >= cols) break;
+        span.after[span.afterCount++] = newRow * cols + newCol;
+    }
+    for (int i = 1; i <= reach; ++i) {
+        int newRow = row - i * rowDir, newCol = col - i * colDir;
+        if (newRow < 0 || newRow >= rows || newCol < 0 || newCol >= cols) break;
+        span.before[span.beforeCount++] = newRow * cols + newCol;
+    }
+    return span;
+}
+
+constexpr LineCell makeLineCell(int rows, int cols, int winLength, int row, int col) {
+    LineCell cell = {};
+    for (int d = 0; d < 4; ++d) {
+        cell.dir[d] = makeLineSpan(rows, cols, winLength - 1, row, col, LINE_DIRECTIONS[d][0], LINE_DIRECTIONS[d][1]);
+    }
+    return cell;
+}
+
+template <int R, int C, int K>
+constexpr std::array<LineCell, R * C> makeLineTable() {
+    std::array<LineCell, R * C> table = {};
+    for (int index = 0; index < R * C; ++index) table[index] = makeLineCell(R, C, K, index / C, index % C);
+    return table;
+}
+
+// Board dimensions, win length and line table as seen by the line scans and
+// the bot's search. FixedShape makes them all compile-time constants, so
+// strides and loop bounds fold away and the table is generated by the
+// compiler; DynamicShape fixes only the win length, for any size with a
+// table built at run time (see LineTable); GenericShape holds any win length.
+template <int R, int C, int K>
+struct FixedShape {
+    static constexpr int rows = R;
+    static constexpr int cols = C;
+    static constexpr int winLength = K;
+    static constexpr std::array<LineCell, R * C> lines = makeLineTable<R, C, K>();
+
+    const LineCell *lineTable() const { return lines.data(); }
+};
+
+template <int K>
+struct DynamicShape {
+    static constexpr int winLength = K;
+    int rows, cols;
+    const LineCell *lines;
+
+    const LineCell *lineTable() const { return lines; }
+};
+
+struct GenericShape {
+    int rows, cols;
+    int winLength;
+    const LineCell *lines;
+
+    const LineCell *lineTable() const { return lines; }
+};
+
+// Line table of a grid: the compiler-generated one for 10x10, 15x15 and
+// 19x19 with five in a row and for 3x3 with three, otherwise built at run
+// time. Run-time tables are shared by every LineTable of the same rows, cols
+// and k while one of them is alive, so the game's GameLogic and its bot's
+// (or thousands of server games of one size) use a single copy.
+class LineTable {
+private:
+    typedef std::vector<LineCell> Cells;
+
+    std::shared_ptr<const Cells> storage; // Null when a constexpr table is used
+    const LineCell *cells;
+
+    static std::mutex &cacheLock() {
+        static std::mutex lock;
+        return lock;
+    }
+
+    static std::map<std::array<int, 3>, std::weak_ptr<const Cells>> &cache() {
+        static std::map<std::array<int, 3>, std::weak_ptr<const Cells>> tables;
+        return tables;
+    }
+
+    // The live run-time table of this shape, built if there is none
+    static std::shared_ptr<const Cells> shared(int rows, int cols, int winLength) {
+        std::lock_guard<std::mutex> guard(cacheLock());
+        std::weak_ptr<const Cells> &entry = cache()[{rows, cols, winLength}];
+        std::shared_ptr<const Cells> table = entry.lock();
+        if (table) return table;
+
+        Cells *built = new Cells((size_t)rows * cols);
+        for (int index = 0; index < rows * cols; ++index) {
+            (*built)[index] = makeLineCell(rows, cols, winLength, index / cols, index % cols);
+        }
+        table.reset(built); // Not make_shared: the cells are freed with the last user, not the last weak_ptr
+        entry = table;
+        return table;
+    }
+
+public:
+    LineTable(int rows, int cols, int winLength) {
+        assert(winLength <= MAX_WIN_LENGTH); // makeLineSpan() writes k - 1 cells per side
+        if (winLength == 5 && rows == 10 && cols == 10) cells = FixedShape<10, 10, 5>::lines.data();
+        else if (winLength == 5 && rows == 15 && cols == 15) cells = FixedShape<15, 15, 5>::lines.data();
+        else if (winLength == 5 && rows == 19 && cols == 19) cells = FixedShape<19, 19, 5>::lines.data();
+        else if (winLength == 3 && rows == 3 && cols == 3) cells = FixedShape<3, 3, 3>::lines.data();
+        else {
+            storage = shared(rows, cols, winLength);
+            cells = storage->data();
+        }
+    }
+
+    // Bytes held by the run-time tables in use
+    static size_t sharedBytes() {
+        std::lock_guard<std::mutex> guard(cacheLock());
+        size_t bytes = 0;
+        for (auto &entry : cache()) {
+            if (std::shared_ptr<const Cells> table = entry.second.lock()) bytes += table->size() * sizeof(LineCell);
+        }
+        return bytes;
+    }
+
+    LineTable(const LineTable &) = delete;
+    LineTable &operator=(const LineTable &) = delete;
+
+    const LineCell *data() const { return cells; }
+};
+
+// Stones of one symbol on each side of a cell along a line (at most k - 1
+// per side) and whether the cell that ends each run is empty (0 or 1; ints
+// keep the scans free of byte-sized partial writes)
+struct LineRun {
+    int before, after;
+    int openBefore, openAfter;
+
+    int count() const { return before + after; }
+    int openEnds() const { return openBefore + openAfter; }
+};
+
+// Walk the line span of a cell in direction D, both ways from the cell
+template <int D>
+LineRun scanLine(const LineCell *lines, const char *cells, int index, char symbol) {
+    const LineSpan &span = lines[index].dir[D];
+    LineRun run = {0, 0, 0, 0};
+
+    for (int i = 0; i < span.afterCount; ++i) {
+        char cell = cells[span.after[i]];
+        if (cell != symbol) {
+            run.openAfter = (cell == ' ');
+            break;
+        }
+        run.after++;
+    }
+
+    for (int i = 0; i < span.beforeCount; ++i) {
+        char cell = cells[span.before[i]];
+        if (cell != symbol) {
+            run.openBefore = (cell == ' ');
+            break;
+        }
+        run.before++;
+    }
+
+    return run;
+}
+
+// Class to manage game logic
+class GameLogic {
+private:
+    Grid &grid;
+    LineTable lines;
+public:
+    GameLogic(Grid &g) : grid(g), lines(g.getRows(), g.getCols(), g.getWinLength()) {}
+
+    // Return a WinSequence structure for the winning sequence
+    WinSequence checkWinner(int row, int col) {
+        const char *cells = grid.getCells();
+        int cols = grid.getCols();
+        int index = row * cols + col;
+        char symbol = cells[index];
+        LineRun runs[4] = {scanLine<0>(lines.data(), cells, index, symbol), scanLine<1>(lines.data(), cells, index, symbol),
+                           scanLine<2>(lines.data(), cells, index, symbol), scanLine<3>(lines.data(), cells, index, symbol)};
+
+        for (int d = 0; d < 4; ++d) {
+            const LineRun &run = runs[d];
+            if (run.count() + 1 >= grid.getWinLength()) {
+                const LineSpan &span = lines.data()[index].dir[d];
+                int start = run.before ? span.before[run.before - 1] : index;
+                int end = run.after ? span.after[run.after - 1] : index;
+                return {true, start / cols, start % cols, end / cols, end % cols};
+            }
+        }
+
+        return {false, -1, -1, -1, -1};
+    }
+
+    const LineCell *getLineTable() const { return lines.data(); }
+};
+
+// Line patterns scored by the bot, strongest first. Lengths include the
+// stone being evaluated; the names are for five in a row, and for a win
+// length k a "four" is k - 1 stones and a "three" k - 2.
+enum Pattern {
+    PATTERN_FIVE,        // k or more in a row
+    PATTERN_OPEN_FOUR,   // Open-ended k - 1
+    PATTERN_CLOSED_FOUR, // Blocked k - 1
+    PATTERN_OPEN_THREE,  // Open-ended k - 2
+    PATTERN_CLOSED_THREE,// Blocked k - 2
+    PATTERN_COUNT,
+    PATTERN_NONE = PATTERN_COUNT
+};
+
+// Evaluation weights used by BotManager. The defaults are the hand-picked
+// scores the bot always used; tuner.cpp fits new ones from self-play games.
+struct EvalWeights {
+    int own[PATTERN_COUNT];  // Score for the bot's own patterns
+    int opp[PATTERN_COUNT];  // Score for the opponent's patterns
+    int center;              // Weight of the distance-to-center bonus
+
+    static const int CENTER_BASE = 50;   // Bonus for a stone on the center cell
+    static const int OPPONENT_SCALE = 2; // Opponent stones count double
+
+    static EvalWeights defaults() {
+        return {{1000, 700, 500, 200, 100}, {-1500, -900, -600, -200, -100}, 1};
+    }
+
+    static const char *patternName(int p) {
+        static const char *names[PATTERN_COUNT] = {"five", "open_four", "closed_four", "open_three", "closed_three"};
+        return names[p];
+    }
+
+    // Load weights written by save(); missing keys keep their current value
+    bool load(const std::string &path) {
+        std::ifstream in(path);
+        if (!in) return false;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields(line);
+            std::string key;
+            int value;
+            if (!(fields >> key >> value)) continue;
+
+            if (key == "center") center = value;
+            for (int p = 0; p < PATTERN_COUNT; ++p) {
+                if (key == std::string("own_") + patternName(p)) own[p] = value;
+                if (key == std::string("opp_") + patternName(p)) opp[p] = value;
+            }
+        }
+        return true;
+    }
+
+    bool save(const std::string &path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+
+        out << "# Tic Tac Toe bot evaluation weights\n";
+        for (int p = 0; p < PATTERN_COUNT; ++p) out << "own_" << patternName(p) << " " << own[p] << "\n";
+        for (int p = 0; p < PATTERN_COUNT; ++p) out << "opp_" << patternName(p) << " " << opp[p] << "\n";
+        out << "center " << center << "\n";
+        return static_cast<bool>(out);
+    }
+};
+
+// Pattern counts of a position; the evaluation is linear in these
+struct EvalFeatures {
+    int own[PATTERN_COUNT];
+    int opp[PATTERN_COUNT];
+    int ownCenter, oppCenter;
+};
+
+struct Move {
+    int row, col;
+};
+
+// One of the best moves found by BotManager::analyze: its score for the side
+// to move and the principal variation, which starts with the move itself
+struct AnalysisLine {
+    int row, col;
+    int score;
+    std::vector<Move> pv;
+};
+
+// Candidate moves of every ply of a search, stacked in one preallocated
+// array: a ply pushes its moves on top and pops them when it returns, so
+// the search itself never touches the heap.
+class MoveStack {
+private:
+    std::vector<Move> moves;
+    size_t top;
+
+public:
+    MoveStack() : top(0) {}
+
+    // Empty the stack with room for at least capacity moves; never shrinks
+    void reserve(size_t capacity) {
+        if (capacity > moves.size()) moves.resize(capacity);
+        top = 0;
+    }
+
+    size_t size() const { return top; }
+    void push(int row, int col) { moves[top++] = {row, col}; }
+    void popTo(size_t mark) { top = mark; }
+    const Move &operator[](size_t i) const { return moves[i]; }
+
+    // Move entry i to position first, shifting the ones in between up by one
+    void moveToFront(size_t first, size_t i) {
+        std::rotate(moves.begin() + first, moves.begin() + i, moves.begin() + i + 1);
+    }
+};
+
+// Search results kept between searches, indexed by position key. Each slot
+// is two 64-bit words written without locks, the first holding key ^ data:
+// a slot torn by a concurrent write fails the key check and reads as a
+// miss, so one table can be shared by bots on several threads (server.cpp).
+class TranspositionTable {
+public:
+    enum Bound { BOUND_NONE, BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+    struct Entry {
+        int score; // From the point of view of the side to move
+        int depth;
+        int bound;
+        int move;  // Best cell index in the position's canonical orientation (Grid::toCanonical), or -1
+    };
+
+    static const size_t DEFAULT_ENTRIES = 1 << 16; // 1 MB
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check, data;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    static uint64_t pack(const Entry &e) {
+        return (uint64_t)(uint32_t)e.score | (uint64_t)(e.depth & 0xFF) << 32 | (uint64_t)(e.bound & 3) << 40 |
+               (uint64_t)((e.move + 1) & 0xFFFF) << 42;
+    }
+
+    static Entry unpack(uint64_t d) {
+        return {(int)(uint32_t)d, (int)(d >> 32 & 0xFF), (int)(d >> 40 & 3), (int)(d >> 42 & 0xFFFF) - 1};
+    }
+
+public:
+    // Entries that fit in the given number of bytes
+    static size_t entriesForBytes(size_t bytes) { return bytes / sizeof(Slot); }
+
+    // Entries are rounded down to a power of two
+    explicit TranspositionTable(size_t entries = DEFAULT_ENTRIES) {
+        size_t size = 1;
+        while (size * 2 <= entries) size *= 2;
+        slots.reset(new Slot[size]);
+        mask = size - 1;
+        clear();
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; ++i) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool probe(uint64_t key, Entry &entry) const {
+        const Slot &slot = slots[key & mask];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) != key || data == 0) return false;
+        entry = unpack(data);
+        return true;
+    }
+
+    // Keep the deeper result when two searches of the same position collide
+    void store(uint64_t key, const Entry &entry) {
+        Slot &slot = slots[key & mask];
+        uint64_t old = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ old) == key && unpack(old).depth > entry.depth) return;
+        uint64_t data = pack(entry);
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    size_t size() const { return mask + 1; }
+
+    // Copy count slots starting at first to or from two words per slot, for snapshots
+    void copyOut(size_t first, size_t count, uint64_t *words) const {
+        for (size_t i = 0; i < count; ++i) {
+            words[2 * i] = slots[first + i].check.load(std::memory_order_relaxed);
+            words[2 * i + 1] = slots[first + i].data.load(std::memory_order_relaxed);
+        }
+    }
+
+    void copyIn(size_t first, size_t count, const uint64_t *words) {
+        for (size_t i = 0; i < count; ++i) {
+            slots[first + i].check.store(words[2 * i], std::memory_order_relaxed);
+            slots[first + i].data.store(words[2 * i + 1], std::memory_order_relaxed);
+        }
+    }
+};
+
+// Set of cell indices with O(1) insert, erase and lookup. Storage is sized
+// once by reset(), so changes never allocate.
+class CellSet {
+private:
+    std::vector<int> members;
+    std::vector<int> position; // Index into members, -1 when absent
+
+public:
+    void reset(int cells) {
+        members.clear();
+        members.reserve(cells);
+        position.assign(cells, -1);
+    }
+
+    void clear() {
+        for (int cell : members) position[cell] = -1;
+        members.clear();
+    }
+
+    bool contains(int cell) const { return position[cell] >= 0; }
+    bool empty() const { return members.empty(); }
+
+    void insert(int cell) {
+        if (position[cell] >= 0) return;
+        position[cell] = (int)members.size();
+        members.push_back(cell);
+    }
+
+    void erase(int cell) {
+        int p = position[cell];
+        if (p < 0) return;
+        int moved = members.back();
+        members[p] = moved;
+        position[moved] = p;
+        members.pop_back();
+        position[cell] = -1;
+    }
+
+    // Smallest cell index (the first in row-major order), or -1 when empty
+    int first() const {
+        return members.empty() ? -1 : *std::min_element(members.begin(), members.end());
+    }
+};
+
+// For each side, the empty cells where a stone would make k in a row (a
+// "five"). A stone only changes the status of the cells within k - 1 of it on
+// its four lines, so update() after each move touches at most 8k - 7 cells.
+class ThreatIndex {
+private:
+    CellSet fives[2];
+    int winLength;
+
+    static int sideOf(char symbol) { return symbol == 'X'; }
+
+    // Recompute the status of one cell for both sides
+    void refresh(const LineCell *lines, const char *cells, int index) {
+        for (int side = 0; side < 2; ++side) {
+            bool five = false;
+            if (cells[index] == ' ') {
+                char symbol = side ? 'X' : 'O';
+                LineRun runs[4] = {scanLine<0>(lines, cells, index, symbol), scanLine<1>(lines, cells, index, symbol),
+                                   scanLine<2>(lines, cells, index, symbol), scanLine<3>(lines, cells, index, symbol)};
+                for (const LineRun &run : runs) {
+                    if (run.count() >= winLength - 1) five = true;
+                }
+            }
+            if (five) fives[side].insert(index);
+            else fives[side].erase(index);
+        }
+    }
+
+public:
+    // Size the sets for a board of the given number of cells and win length
+    void reset(int cells, int k) {
+        winLength = k;
+        for (int side = 0; side < 2; ++side) fives[side].reset(cells);
+    }
+
+    // Recompute every cell of the board
+    void rebuild(const LineCell *lines, const char *cells, int cellCount) {
+        for (int side = 0; side < 2; ++side) fives[side].clear();
+        for (int index = 0; index < cellCount; ++index) refresh(lines, cells, index);
+    }
+
+    // Call after a stone was placed on or removed from index
+    void update(const LineCell *lines, const char *cells, int index) {
+        refresh(lines, cells, index);
+        for (int d = 0; d < 4; ++d) {
+            const LineSpan &span = lines[index].dir[d];
+            for (int i = 0; i < span.afterCount; ++i) refresh(lines, cells, span.after[i]);
+            for (int i = 0; i < span.beforeCount; ++i) refresh(lines, cells, span.before[i]);
+        }
+    }
+
+    // First cell in row-major order where symbol makes five, or -1
+    int firstFive(char symbol) const { return fives[sideOf(symbol)].first(); }
+};
+
+// Scratch memory of a search: the move stack, the candidate marks and the
+// threat index with the grid state it was last synced to. A bot borrows the
+// context of the thread it searches on for the length of one search, so a
+// bot that is not searching holds none of it: a server keeps one context per
+// worker thread instead of one per game. Contexts only grow, so once one has
+// served the largest board and depth, searches on it do not allocate.
+struct SearchContext {
+    MoveStack moveStack;
+    std::vector<unsigned> candidateMark; // Stamp per cell, dedupes candidates
+    unsigned markStamp = 0;
+    ThreatIndex threats;
+    uint64_t threatOwner = 0; // Bot the threat index follows, 0 for none
+    int syncedMoves = -1;     // Grid moves the threat index has seen, -1 before the first sync
+    uint64_t syncedHash = 0;  // Grid hash at that point
+
+    // The calling thread's context
+    static SearchContext &local() {
+        thread_local SearchContext context;
+        return context;
+    }
+};
+
+// Strength levels of the bot. A level is a node budget per move rather than
+// a depth, so its cost is about the same on any board size, and evaluation
+// noise that makes the weaker levels misjudge positions. With the same seed
+// a level always plays the same moves.
+struct BotLevel {
+    const char *name;
+    int depth;       // Deepest iteration
+    long long nodes; // Node budget per move
+    int noise;       // Largest evaluation noise either way
+};
+
+inline const BotLevel BOT_LEVELS[] = {
+    {"Easy", 2, 2000, 400},
+    {"Medium", 4, 10000, 150},
+    {"Hard", 8, 50000, 40},
+    {"Expert", 16, 250000, 0},
+};
+constexpr int BOT_LEVEL_COUNT = sizeof(BOT_LEVELS) / sizeof(BOT_LEVELS[0]);
+
+// BotManager class for bot strategy and decision making
+// The search and evaluation are templates over the board shape; withShape()
+// picks a FixedShape instantiation for the common sizes and DynamicShape for
+// everything else. Scratch memory is borrowed from the searching thread's
+// SearchContext for each move, so an idle bot keeps only its settings.
+class BotManager {
+private:
+    Grid &grid;
+    char botSymbol;
+    GameLogic gameLogic;
+    char opponentSymbol;
+    int lastRow, lastCol;
+    EvalWeights weights;
+    int searchDepth;
+    bool verbose;
+    long long nodeCount;
+    SearchContext *context; // Borrowed from the searching thread, set during a search only
+    uint64_t searchId;      // Tells this bot's threat index apart in a shared context
+    std::unique_ptr<TranspositionTable> ownTable; // Unused when the table is shared
+    TranspositionTable *table;
+    uint64_t contextKey; // Separates this bot's entries from other bots' in a shared table
+    unsigned pruning;    // Pruning flags in use
+    const SolvedTable *solvedTable; // Perfect play for this board, if it is small enough to be solved
+    long long timeLimitMs;          // Longest a move may take, 0 without a limit
+    long long nodeLimit;            // Most nodes a move may search, 0 without a limit
+    int noiseAmplitude;             // Largest evaluation noise either way, 0 for none
+    uint64_t noiseSeed;
+    std::chrono::steady_clock::time_point searchStart, deadline;
+    bool clockRunning; // The time and node limits apply: set once the first iteration is done
+    bool timeUp;       // A limit was reached; the search unwinds and its results are dropped
+
+    static constexpr int SCORE_INFINITY = 1 << 30;
+    static constexpr int SCORE_WIN = 1 << 29; // K in a row, above any evaluation
+    static constexpr int ASPIRATION_WINDOW = 100;
+    static constexpr int NULL_MOVE_REDUCTION = 2; // Extra plies taken off the null-move search
+    static constexpr int LMR_FULL_MOVES = 3;      // Moves searched at full depth before reducing
+    static constexpr int QUIESCENCE_PLIES = 6;    // Longest forcing sequence searched past the leaves
+    static constexpr uint64_t SIDE_KEY = 0x5851F42D4C957F2Dull; // Mixed in when the opponent is to move
+    static constexpr long long CLOCK_CHECK_NODES = 256;        // Nodes between looks at the clock
+
+    // Call f with the grid's shape: fixed at compile time for 10x10, 15x15 and
+    // 19x19 with five in a row and 3x3 with three, a compile-time win length
+    // for k = 3, 4 and 5 on other sizes, and fully run-time otherwise
+    template <class F>
+    auto withShape(F f) {
+        int rows = grid.getRows(), cols = grid.getCols();
+        const LineCell *lines = gameLogic.getLineTable();
+        switch (grid.getWinLength()) {
+        case 5:
+            if (rows == 10 && cols == 10) return f(FixedShape<10, 10, 5>());
+            if (rows == 15 && cols == 15) return f(FixedShape<15, 15, 5>());
+            if (rows == 19 && cols == 19) return f(FixedShape<19, 19, 5>());
+            return f(DynamicShape<5>{rows, cols, lines});
+        case 4:
+            return f(DynamicShape<4>{rows, cols, lines});
+        case 3:
+            if (rows == 3 && cols == 3) return f(FixedShape<3, 3, 3>());
+            return f(DynamicShape<3>{rows, cols, lines});
+        default:
+            return f(GenericShape{rows, cols, grid.getWinLength(), lines});
+        }
+    }
+
+    // Evaluate the overall grid state
+    template <class Shape>
+    int evaluateGrid(const Shape &shape) {
+        const char *cells = grid.getCells();
+        int score = 0;
+
+        // Evaluate each cell
+        for (int r = 0; r < shape.rows; ++r) {
+            for (int c = 0; c < shape.cols; ++c) {
+                char symbol = cells[r * shape.cols + c];
+                if (symbol == botSymbol) {
+                    score += evaluatePosition(shape, r, c, botSymbol);
+                } else if (symbol == opponentSymbol) {
+                    score -= evaluatePosition(shape, r, c, opponentSymbol) * EvalWeights::OPPONENT_SCALE; // Penalize opponent progress
+                }
+            }
+        }
+        if (noiseAmplitude > 0) score += evalNoise();
+        return score;
+    }
+
+    // Noise in [-noiseAmplitude, noiseAmplitude], a hash of the position and
+    // the seed, so a position always gets the same noise for the same seed.
+    // The position's canonical key is hashed, as in positionKey(), so its
+    // symmetric images, which share a table entry, get the same noise.
+    int evalNoise() {
+        uint64_t x = grid.getCanonicalHash() ^ noiseSeed;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull; // SplitMix64 finalizer
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return (int)(x % (uint64_t)(2 * noiseAmplitude + 1)) - noiseAmplitude;
+    }
+
+    // Distance-to-center bonus of a cell, measured from the true center (in
+    // half cells, so an even side has no favoured middle row), so mirrored
+    // positions, which share a table entry, score the same
+    template <class Shape>
+    static int centerBonus(const Shape &shape, int row, int col) {
+        return EvalWeights::CENTER_BASE - (abs(2 * row - (shape.rows - 1)) + abs(2 * col - (shape.cols - 1))) / 2;
+    }
+
+    // Evaluate a single position for a specific symbol
+    template <class Shape>
+    int evaluatePosition(const Shape &shape, int row, int col, char symbol) {
+        const int *patternScore = (symbol == botSymbol) ? weights.own : weights.opp;
+
+        // Reward moves closer to the center
+        int score = weights.center * centerBonus(shape, row, col);
+
+        int patterns[4];
+        classifyLines(shape, row, col, symbol, patterns);
+        for (int pattern : patterns) {
+            if (pattern != PATTERN_NONE) score += patternScore[pattern];
+        }
+
+        return score;
+    }
+
+    // Classify a line run as a Pattern, by how many stones it is short of
+    // the shape's win length and its open ends. Runs two or more short, or
+    // blocked at both ends, score nothing.
+    template <class Shape>
+    static int classifyRun(const Shape &shape, const LineRun &run) {
+        int missing = shape.winLength - 1 - run.count();
+        if (missing <= 0) return PATTERN_FIVE; // Winning or critical threat
+        if (missing > 2 || run.openEnds() == 0) return PATTERN_NONE;
+        int blocked = (missing == 1) ? PATTERN_CLOSED_FOUR : PATTERN_CLOSED_THREE;
+        return blocked - (run.openEnds() - 1); // The open pattern comes just before the blocked one
+    }
+
+    // Pattern of the lines through a cell in all four directions
+    template <class Shape>
+    void classifyLines(const Shape &shape, int row, int col, char symbol, int patterns[4]) {
+        const char *cells = grid.getCells();
+        const LineCell *lines = shape.lineTable();
+        int index = row * shape.cols + col;
+        patterns[0] = classifyRun(shape, scanLine<0>(lines, cells, index, symbol));
+        patterns[1] = classifyRun(shape, scanLine<1>(lines, cells, index, symbol));
+        patterns[2] = classifyRun(shape, scanLine<2>(lines, cells, index, symbol));
+        patterns[3] = classifyRun(shape, scanLine<3>(lines, cells, index, symbol));
+    }
+
+    // Key of the current position up to symmetry with side to move, for the
+    // transposition table. Moves stored under the key are in the canonical
+    // orientation; symmetry receives the map to it.
+    uint64_t positionKey(char side, int &symmetry) {
+        symmetry = grid.getCanonicalSymmetry();
+        return grid.getImageHash(symmetry) ^ contextKey ^ (side == botSymbol ? 0 : SIDE_KEY);
+    }
+
+    // Put the move on cell index first among moves [first, last), if it is there
+    void orderFirst(int cols, size_t first, size_t last, int index) {
+        if (index < 0) return;
+        MoveStack &moveStack = context->moveStack;
+        for (size_t i = first; i < last; ++i) {
+            if (moveStack[i].row * cols + moveStack[i].col == index) {
+                moveStack.moveToFront(first, i);
+                return;
+            }
+        }
+    }
+
+    // Strongest pattern a stone of symbol on cell index makes (or, for an
+    // occupied cell, is part of) in any direction; lower is stronger
+    template <class Shape>
+    int strongestPattern(const Shape &shape, int index, char symbol) {
+        const char *cells = grid.getCells();
+        const LineCell *lines = shape.lineTable();
+        return std::min(std::min(classifyRun(shape, scanLine<0>(lines, cells, index, symbol)),
+                                 classifyRun(shape, scanLine<1>(lines, cells, index, symbol))),
+                        std::min(classifyRun(shape, scanLine<2>(lines, cells, index, symbol)),
+                                 classifyRun(shape, scanLine<3>(lines, cells, index, symbol))));
+    }
+
+    // A move that makes a five, four or open three, or stops one of the
+    // opponent's. These are never reduced or pruned.
+    template <class Shape>
+    bool isTactical(const Shape &shape, int index, char side, char other) {
+        return strongestPattern(shape, index, side) <= PATTERN_OPEN_THREE ||
+               strongestPattern(shape, index, other) <= PATTERN_OPEN_THREE;
+    }
+
+    // Most a quiet move can gain, per ply left: a closed three (k - 2 stones)
+    // for either side plus the center bonus. With the default weights and
+    // k = 5 that is 1000; the largest gain seen on random positions was about 650.
+    int futilityMargin(int depth) const {
+        int closedThree = abs(weights.own[PATTERN_CLOSED_THREE]) + abs(weights.opp[PATTERN_CLOSED_THREE]) * EvalWeights::OPPONENT_SCALE;
+        return depth * ((grid.getWinLength() - 2) * closedThree + EvalWeights::CENTER_BASE * abs(weights.center) * EvalWeights::OPPONENT_SCALE);
+    }
+
+    // Whether the last stone placed completed k in a row
+    template <class Shape>
+    bool lastMoveWon(const Shape &shape) {
+        int moves = grid.getMoveCount();
+        if (moves == 0) return false;
+        int index = grid.getMoveRow(moves - 1) * shape.cols + grid.getMoveCol(moves - 1);
+        return strongestPattern(shape, index, grid.getCells()[index]) == PATTERN_FIVE;
+    }
+
+    // Quiescence search at the leaves: extends only forcing moves until the
+    // position is quiet, so the evaluation never lands in the middle of a
+    // threat exchange. Side wins at once with a five (k in a row), must block
+    // a single five of the opponent and loses to two; otherwise it may stand
+    // on the static score or play a four of its own or a block of an open three.
+    template <class Shape>
+    int quiesce(const Shape &shape, int ply, int alpha, int beta, char side) {
+        nodeCount++;
+        if (outOfTime()) return 0;
+        if (lastMoveWon(shape)) return -SCORE_WIN;
+        int standPat = evaluateGrid(shape);
+        if (side != botSymbol) standPat = -standPat;
+        if (grid.isFull()) return standPat;
+
+        // Push the forcing moves above the candidates
+        char other = (side == 'O') ? 'X' : 'O';
+        MoveStack &moveStack = context->moveStack;
+        size_t first = moveStack.size();
+        generateCandidateMoves(shape);
+        size_t last = moveStack.size();
+        int opponentFives = 0;
+        for (size_t i = first; i < last; ++i) {
+            int r = moveStack[i].row, c = moveStack[i].col;
+            int own = strongestPattern(shape, r * shape.cols + c, side);
+            if (own == PATTERN_FIVE) {
+                moveStack.popTo(first);
+                return SCORE_WIN;
+            }
+            int theirs = strongestPattern(shape, r * shape.cols + c, other);
+            if (theirs == PATTERN_FIVE) opponentFives++;
+            if (own <= PATTERN_CLOSED_FOUR || theirs <= PATTERN_OPEN_FOUR) moveStack.push(r, c);
+        }
+
+        int bestScore = standPat;
+        if (opponentFives >= 2) {
+            bestScore = -SCORE_WIN;
+        } else if (ply < QUIESCENCE_PLIES && (opponentFives == 1 || standPat < beta)) {
+            if (opponentFives == 1) {
+                bestScore = -SCORE_WIN; // The block is the only move
+            } else {
+                alpha = std::max(alpha, standPat);
+            }
+            for (size_t i = last; i < moveStack.size(); ++i) {
+                int r = moveStack[i].row, c = moveStack[i].col;
+                if (opponentFives == 1 && strongestPattern(shape, r * shape.cols + c, other) != PATTERN_FIVE) continue;
+
+                grid.makeMove(r, c, side);
+                int score = -quiesce(shape, ply + 1, -beta, -alpha, other);
+                grid.unmakeMove();
+
+                bestScore = std::max(bestScore, score);
+                alpha = std::max(alpha, score);
+                if (alpha >= beta) break;
+            }
+        }
+        moveStack.popTo(first);
+        return bestScore;
+    }
+
+    // Negamax alpha-beta with principal variation search: the first move gets
+    // the full window, the rest a null window and a re-search only if they
+    // beat alpha. Scores are from the point of view of side, the symbol to move.
+    // In null-window nodes, when the pruning flags allow it:
+    // - null move: let the opponent move twice at reduced depth and, if that
+    //   still fails high, confirm with a normal reduced-depth search
+    // - futility: one or two plies from the leaves, skip quiet moves when the
+    //   static score plus futilityMargin() cannot reach alpha
+    // - late move reductions: quiet moves after the first few are searched a
+    //   ply shallower and re-searched at full depth if they beat alpha
+    template <class Shape>
+    int search(const Shape &shape, int depth, int alpha, int beta, char side, bool allowNull = true) {
+        if (depth == 0) return quiesce(shape, 0, alpha, beta, side);
+        nodeCount++;
+        if (outOfTime()) return 0;
+        if (lastMoveWon(shape)) return -SCORE_WIN;
+        if (grid.isFull()) {
+            int score = evaluateGrid(shape); // Evaluate the full grid
+            return side == botSymbol ? score : -score;
+        }
+
+        char other = (side == 'O') ? 'X' : 'O';
+        bool nullWindow = (beta - alpha == 1);
+        int symmetry;
+        uint64_t key = positionKey(side, symmetry);
+        TranspositionTable::Entry entry;
+        int hashMove = -1;
+        if (table->probe(key, entry)) {
+            if (entry.move >= 0) hashMove = grid.fromCanonical(symmetry, entry.move);
+            if (entry.depth >= depth) {
+                if (entry.bound == TranspositionTable::BOUND_EXACT) return entry.score;
+                if (entry.bound == TranspositionTable::BOUND_LOWER && entry.score >= beta) return entry.score;
+                if (entry.bound == TranspositionTable::BOUND_UPPER && entry.score <= alpha) return entry.score;
+            }
+        }
+
+        bool useNull = (pruning & PRUNE_NULL_MOVE) && nullWindow && allowNull && depth > NULL_MOVE_REDUCTION;
+        bool useFutility = (pruning & PRUNE_FUTILITY) && nullWindow && depth <= 2;
+        int staticScore = 0;
+        if (useNull || useFutility) {
+            staticScore = evaluateGrid(shape);
+            if (side != botSymbol) staticScore = -staticScore;
+        }
+
+        // Null move: unsafe when the opponent's last stone made a threat, since
+        // passing would hand them the win the search then fails to see
+        if (useNull && staticScore >= beta) {
+            int moves = grid.getMoveCount();
+            int lastIndex = (moves > 0) ? grid.getMoveRow(moves - 1) * shape.cols + grid.getMoveCol(moves - 1) : -1;
+            if (lastIndex < 0 || strongestPattern(shape, lastIndex, other) > PATTERN_OPEN_THREE) {
+                int score = -search(shape, depth - 1 - NULL_MOVE_REDUCTION, -beta, -beta + 1, other, false);
+                if (score >= beta) {
+                    // Verify with a normal search of this position at the null-move depth
+                    score = search(shape, depth - NULL_MOVE_REDUCTION, alpha, beta, side, false);
+                    if (score >= beta) return score;
+                }
+            }
+        }
+        bool futile = useFutility && staticScore + futilityMargin(depth) <= alpha;
+
+        MoveStack &moveStack = context->moveStack;
+        size_t first = moveStack.size();
+        generateCandidateMoves(shape);
+        size_t last = moveStack.size();
+        orderFirst(shape.cols, first, last, hashMove);
+
+        int originalAlpha = alpha;
+        int bestScore = -SCORE_INFINITY, bestMove = -1;
+        for (size_t i = first; i < last; ++i) {
+            int r = moveStack[i].row, c = moveStack[i].col;
+            int index = r * shape.cols + c;
+            bool quiet = (i > first) && (futile || (pruning & PRUNE_LMR)) && !isTactical(shape, index, side, other);
+            if (quiet && futile) {
+                bestScore = std::max(bestScore, staticScore + futilityMargin(depth)); // Bound for the skipped move
+                continue;
+            }
+
+            grid.makeMove(r, c, side);
+            int score;
+            if (i == first) {
+                score = -search(shape, depth - 1, -beta, -alpha, other);
+            } else {
+                int reduction = (quiet && depth >= 3 && i - first >= LMR_FULL_MOVES) ? 1 : 0;
+                score = -search(shape, depth - 1 - reduction, -alpha - 1, -alpha, other);
+                if (reduction > 0 && score > alpha) score = -search(shape, depth - 1, -alpha - 1, -alpha, other); // Verify at full depth
+                if (score > alpha && score < beta) score = -search(shape, depth - 1, -beta, -alpha, other); // Re-search
+            }
+            grid.unmakeMove();
+            if (timeUp) break;
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = index;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) break; // Alpha-beta pruning
+        }
+        moveStack.popTo(first);
+        if (timeUp) return 0; // Unfinished, must not reach the table
+
+        int bound = bestScore <= originalAlpha ? TranspositionTable::BOUND_UPPER
+                    : bestScore >= beta        ? TranspositionTable::BOUND_LOWER
+                                               : TranspositionTable::BOUND_EXACT;
+        table->store(key, {bestScore, depth, bound, bestMove >= 0 ? grid.toCanonical(symmetry, bestMove) : -1});
+        return bestScore;
+    }
+
+    // Search the bot's moves [first, last) on the move stack as one node and
+    // return the best score for the bot. The best move is moved to first
+    // unless every move failed low: their scores are only upper bounds, so
+    // the move at first, the previous iteration's best, stays in place.
+    template <class Shape>
+    int searchRoot(const Shape &shape, int depth, int alpha, int beta, size_t first, size_t last) {
+        MoveStack &moveStack = context->moveStack;
+        int originalAlpha = alpha;
+        int bestScore = -SCORE_INFINITY;
+        size_t best = first;
+        for (size_t i = first; i < last; ++i) {
+            int r = moveStack[i].row, c = moveStack[i].col;
+            grid.makeMove(r, c, botSymbol);
+            int score;
+            if (i == first) {
+                score = -search(shape, depth - 1, -beta, -alpha, opponentSymbol);
+            } else {
+                score = -search(shape, depth - 1, -alpha - 1, -alpha, opponentSymbol);
+                if (score > alpha && score < beta) score = -search(shape, depth - 1, -beta, -alpha, opponentSymbol);
+            }
+            grid.unmakeMove();
+            if (timeUp) return 0; // The caller drops this iteration
+
+            if (score > bestScore) {
+                bestScore = score;
+                best = i;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) break;
+        }
+        if (bestScore > originalAlpha) moveStack.moveToFront(first, best);
+        return bestScore;
+    }
+
+    // Iterative deepening over the root moves [first, last), each iteration
+    // searched in an aspiration window around the previous score and widened
+    // on a fail. Leaves the best move at first. Under a time or node limit,
+    // an iteration cut off by the limit is dropped, keeping the last finished
+    // iteration's move (or a move that failed high since), and no iteration starts
+    // after half the time or nodes are used, since it would likely not finish.
+    template <class Shape>
+    int searchIterative(const Shape &shape, int maxDepth, size_t first, size_t last) {
+        int score = 0;
+        for (int depth = 1; depth <= maxDepth; ++depth) {
+            if (clockRunning && timeLimitMs > 0 && std::chrono::steady_clock::now() - searchStart >= (deadline - searchStart) / 2) break;
+            if (clockRunning && nodeLimit > 0 && nodeCount >= nodeLimit / 2) break;
+
+            int window = ASPIRATION_WINDOW;
+            int alpha = (depth > 1) ? score - window : -SCORE_INFINITY;
+            int beta = (depth > 1) ? score + window : SCORE_INFINITY;
+
+            while (true) {
+                int result = searchRoot(shape, depth, alpha, beta, first, last);
+                if (timeUp) return score;
+                if (result <= alpha && alpha > -SCORE_INFINITY) {
+                    window = std::min(window * 4, SCORE_INFINITY);
+                    alpha = std::max(result - window, -SCORE_INFINITY);
+                } else if (result >= beta && beta < SCORE_INFINITY) {
+                    window = std::min(window * 4, SCORE_INFINITY);
+                    beta = std::min(result + window, SCORE_INFINITY);
+                } else {
+                    score = result;
+                    break;
+                }
+            }
+            clockRunning = timeLimitMs > 0 || nodeLimit > 0;
+        }
+        return score;
+    }
+
+    // Separates entries of bots with evaluation noise in a shared table; 0 without noise
+    uint64_t noiseKey() const {
+        if (noiseAmplitude == 0) return 0;
+        return (noiseSeed ^ (uint64_t)noiseAmplitude << 48) * 0x9E3779B97F4A7C15ull;
+    }
+
+    // Whether the node limit is reached or the deadline has passed, looking
+    // at the clock every CLOCK_CHECK_NODES nodes
+    bool outOfTime() {
+        if (!clockRunning || timeUp) return timeUp;
+        if (nodeLimit > 0 && nodeCount >= nodeLimit) timeUp = true;
+        if (timeLimitMs > 0 && nodeCount % CLOCK_CHECK_NODES == 0 && std::chrono::steady_clock::now() >= deadline) timeUp = true;
+        return timeUp;
+    }
+
+    // Bring the threat index up to date with the moves played since the last
+    // bot move, or rebuild it if the grid changed in any other way
+    void syncThreats() {
+        const LineCell *lines = gameLogic.getLineTable();
+        const char *cells = grid.getCells();
+        int cols = grid.getCols(), moves = grid.getMoveCount();
+
+        bool incremental = (context->syncedMoves >= 0 && moves >= context->syncedMoves);
+        if (incremental) {
+            uint64_t expected = context->syncedHash;
+            for (int i = context->syncedMoves; i < moves; ++i) {
+                int index = grid.getMoveRow(i) * cols + grid.getMoveCol(i);
+                expected ^= Grid::zobristKey(index, cells[index]);
+            }
+            incremental = (expected == grid.getHash());
+        }
+
+        if (incremental) {
+            for (int i = context->syncedMoves; i < moves; ++i) context->threats.update(lines, cells, grid.getMoveRow(i) * cols + grid.getMoveCol(i));
+        } else {
+            context->threats.rebuild(lines, cells, grid.getRows() * cols);
+        }
+        context->syncedMoves = moves;
+        context->syncedHash = grid.getHash();
+    }
+
+    // Check if the bot or opponent can win in the next move
+    bool canWinNextMove(char symbol, int &winRow, int &winCol) {
+        int index = context->threats.firstFive(symbol);
+        if (index < 0) return false; // No winning move found
+        winRow = index / grid.getCols();
+        winCol = index % grid.getCols();
+        return true; // Winning move found
+    }
+
+    // Borrow the calling thread's search context for a search of plies
+    // plies below the root moves, growing it for the grid if needed. The
+    // threat index is reset when another bot used it last.
+    void borrowContext(int plies) {
+        context = &SearchContext::local();
+        size_t cells = (size_t)grid.getRows() * grid.getCols();
+        context->moveStack.reserve(cells * (plies + 1 + 2 * QUIESCENCE_PLIES)); // Quiescence nodes push candidates and forcing moves
+        if (context->candidateMark.size() < cells) context->candidateMark.resize(cells, 0); // Stale stamps are all below the next one
+        if (context->threatOwner != searchId) {
+            context->threats.reset((int)cells, grid.getWinLength());
+            context->threatOwner = searchId;
+            context->syncedMoves = -1;
+        }
+    }
+
+    // Unique id of every bot, never 0
+    static uint64_t newSearchId() {
+        static std::atomic<uint64_t> next(1);
+        return next++;
+    }
+
+    // Push the empty cells next to occupied cells onto the move stack, in row-major order.
+    // On an empty grid the center is the only candidate.
+    template <class Shape>
+    void generateCandidateMoves(const Shape &shape) {
+        const char *cells = grid.getCells();
+        MoveStack &moveStack = context->moveStack;
+        std::vector<unsigned> &candidateMark = context->candidateMark;
+        size_t first = moveStack.size();
+        unsigned markStamp = ++context->markStamp;
+        if (markStamp == 0) {
+            std::fill(candidateMark.begin(), candidateMark.end(), 0);
+            markStamp = context->markStamp = 1;
+        }
+
+        for (int r = 0; r < shape.rows; ++r) {
+            for (int c = 0; c < shape.cols; ++c) {
+                if (cells[r * shape.cols + c] != ' ') {
+                    for (int dr = -1; dr <= 1; ++dr) {
+                        for (int dc = -1; dc <= 1; ++dc) {
+                            int newRow = r + dr;
+                            int newCol = c + dc;
+                            if (newRow >= 0 && newRow < shape.rows && newCol >= 0 && newCol < shape.cols) {
+                                candidateMark[newRow * shape.cols + newCol] = markStamp;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        for (int r = 0; r < shape.rows; ++r) {
+            for (int c = 0; c < shape.cols; ++c) {
+                int index = r * shape.cols + c;
+                if (candidateMark[index] == markStamp && cells[index] == ' ') {
+                    moveStack.push(r, c);
+                }
+            }
+        }
+
+        int center = (shape.rows / 2) * shape.cols + shape.cols / 2;
+        if (moveStack.size() == first && cells[center] == ' ') {
+            moveStack.push(shape.rows / 2, shape.cols / 2);
+        }
+    }
+
+    // Principal variation after the move just made, read from the
+    // transposition table, with side to move next
+    template <class Shape>
+    void appendVariation(const Shape &shape, char side, int plies, std::vector<Move> &pv) {
+        int made = 0, symmetry;
+        TranspositionTable::Entry entry;
+        while (made < plies && !lastMoveWon(shape) && table->probe(positionKey(side, symmetry), entry) && entry.move >= 0) {
+            int move = grid.fromCanonical(symmetry, entry.move);
+            int r = move / shape.cols, c = move % shape.cols;
+            if (!grid.isCellEmpty(r, c)) break;
+            grid.makeMove(r, c, side);
+            pv.push_back({r, c});
+            made++;
+            side = (side == 'O') ? 'X' : 'O';
+        }
+        while (made-- > 0) grid.unmakeMove();
+    }
+
+    // Multi-PV search: every move of side gets a window whose lower edge is
+    // the count-th best score so far, so the top count scores are exact and
+    // the rest only fail low. Iterative deepening puts the previous best
+    // lines first; entries the bot stored on its own search are reused.
+    template <class Shape>
+    std::vector<AnalysisLine> analyzeMoves(const Shape &shape, char side, int count, int depth) {
+        char other = (side == 'O') ? 'X' : 'O';
+        std::vector<AnalysisLine> lines;
+        MoveStack &moveStack = context->moveStack;
+        size_t first = moveStack.size();
+        generateCandidateMoves(shape);
+        size_t last = moveStack.size();
+
+        for (int d = 1; d <= depth; ++d) {
+            for (auto it = lines.rbegin(); it != lines.rend(); ++it) orderFirst(shape.cols, first, last, it->row * shape.cols + it->col);
+            lines.clear();
+
+            for (size_t i = first; i < last; ++i) {
+                int floor = ((int)lines.size() == count) ? lines.back().score : -SCORE_INFINITY;
+                int r = moveStack[i].row, c = moveStack[i].col;
+                grid.makeMove(r, c, side);
+                int score = -search(shape, d - 1, -SCORE_INFINITY, -floor, other);
+                if (score > floor) {
+                    AnalysisLine line = {r, c, score, {{r, c}}};
+                    if (d == depth) appendVariation(shape, other, d - 1, line.pv);
+                    auto at = std::find_if(lines.begin(), lines.end(), [&](const AnalysisLine &l) { return l.score < score; });
+                    lines.insert(at, line);
+                    if ((int)lines.size() > count) lines.pop_back();
+                }
+                grid.unmakeMove();
+            }
+        }
+        moveStack.popTo(first);
+        return lines;
+    }
+
+    template <class Shape>
+    void searchMove(const Shape &shape) {
+        // Solved boards are answered from the table
+        int solvedIndex;
+        if (solvedTable && solvedTable->bestMove(grid.getCells(), botSymbol, solvedIndex)) {
+            lastRow = solvedIndex / shape.cols;
+            lastCol = solvedIndex % shape.cols;
+            grid.makeMove(lastRow, lastCol, botSymbol);
+            if (verbose) std::cout << "Bot plays the solved move (" << lastRow << ", " << lastCol << ")." << std::endl;
+            return;
+        }
+
+        int winRow, winCol;
+        syncThreats();
+
+        // Check if the bot can win immediately
+        if (canWinNextMove(botSymbol, winRow, winCol)) {
+            grid.makeMove(winRow, winCol, botSymbol);
+            lastRow = winRow;
+            lastCol = winCol;
+            if (verbose) std::cout << "Bot wins immediately by placing at (" << winRow << ", " << winCol << ")." << std::endl;
+            return;
+        }
+
+        // Strategic move: the bot's move plus searchDepth replies, then the
+        // forcing moves in quiescence, which also finds the blocks
+        int bestRow = -1, bestCol = -1;
+        MoveStack &moveStack = context->moveStack;
+        size_t first = moveStack.size();
+        generateCandidateMoves(shape);
+        size_t last = moveStack.size();
+
+        if (last > first) {
+            searchIterative(shape, searchDepth + 1, first, last);
+            bestRow = moveStack[first].row;
+            bestCol = moveStack[first].col;
+        }
+        moveStack.popTo(first);
+
+        if (bestRow != -1 && bestCol != -1) {
+            grid.makeMove(bestRow, bestCol, botSymbol);
+            lastRow = bestRow;
+            lastCol = bestCol;
+            if (verbose) std::cout << "Bot places strategically at (" << bestRow << ", " << bestCol << ")." << std::endl;
+        } else {
+            if (verbose) std::cout << "Bot could not find a valid move." << std::endl;
+        }
+    }
+
+public:
+    // Selective search features, each with its own switch for measuring
+    enum Pruning {
+        PRUNE_NONE = 0,
+        PRUNE_LMR = 1,       // Late move reductions
+        PRUNE_NULL_MOVE = 2, // Null-move pruning
+        PRUNE_FUTILITY = 4,  // Futility pruning near the leaves
+        PRUNE_ALL = PRUNE_LMR | PRUNE_NULL_MOVE | PRUNE_FUTILITY
+    };
+
+    // Pass sharedTable to use one transposition table for many bots; by
+    // default each bot allocates its own
+    BotManager(Grid &g, char symbol, const EvalWeights &w = EvalWeights::defaults(),
+               TranspositionTable *sharedTable = nullptr)
+        : grid(g), botSymbol(symbol), gameLogic(g), opponentSymbol(symbol == 'O' ? 'X' : 'O'), lastRow(-1), lastCol(-1),
+          weights(w), searchDepth(2), verbose(true), nodeCount(0), context(nullptr), searchId(newSearchId()), table(sharedTable),
+          pruning(PRUNE_ALL), solvedTable(SolvedTable::find(g.getRows(), g.getCols(), g.getWinLength())), timeLimitMs(0),
+          nodeLimit(0), noiseAmplitude(0), noiseSeed(0), clockRunning(false), timeUp(false) {
+        if (!table) {
+            ownTable.reset(new TranspositionTable());
+            table = ownTable.get();
+        }
+        // Keyed on the board size, the win length and the bot's side, the evaluation's point of view
+        contextKey = Grid::zobristKey(-1 - ((g.getWinLength() * 64 + g.getRows()) * 1024 + g.getCols()), symbol);
+    }
+
+    void setSearchDepth(int depth) { searchDepth = depth; }
+    void setVerbose(bool on) { verbose = on; }
+
+    // Combination of Pruning flags; all are on by default
+    void setPruning(unsigned flags) { pruning = flags; }
+
+    // Longest the next moves may take, in milliseconds, or 0 for no limit.
+    // The search still stops at the search depth; it stops earlier, with
+    // the best move of the deepest finished iteration, when time runs out.
+    // Depth 1 always finishes.
+    void setTimeLimit(long long ms) { timeLimitMs = ms; }
+    long long getTimeLimit() const { return timeLimitMs; }
+
+    // Most nodes the next moves may search, or 0 for no limit; like the time
+    // limit, but the same position always gets the same move
+    void setNodeLimit(long long nodes) { nodeLimit = nodes; }
+    long long getNodeLimit() const { return nodeLimit; }
+
+    // Add noise of up to amplitude either way to every evaluation, the same
+    // for a position and seed. The bot's entries in a shared table are kept
+    // apart from those of bots with other noise.
+    void setEvalNoise(int amplitude, uint64_t seed) {
+        contextKey ^= noiseKey();
+        noiseAmplitude = std::max(0, amplitude);
+        noiseSeed = seed;
+        contextKey ^= noiseKey();
+    }
+
+    // Play at one of BOT_LEVELS: its depth, node limit and noise
+    void setLevel(int level, uint64_t seed) {
+        const BotLevel &l = BOT_LEVELS[std::max(0, std::min(BOT_LEVEL_COUNT - 1, level))];
+        setSearchDepth(l.depth);
+        setNodeLimit(l.nodes);
+        setEvalNoise(l.noise, seed);
+    }
+
+    void makeMove() {
+        nodeCount = 0;
+        searchStart = std::chrono::steady_clock::now();
+        deadline = searchStart + std::chrono::milliseconds(timeLimitMs);
+        clockRunning = timeUp = false;
+        borrowContext(searchDepth + 1);
+        withShape([&](auto shape) { searchMove(shape); });
+        clockRunning = false;
+        context = nullptr;
+    }
+
+    // Grow the calling thread's search context for this bot's grid and
+    // depth ahead of time, so that its next move does not allocate
+    void reserveContext() {
+        borrowContext(searchDepth + 1);
+        context = nullptr;
+    }
+
+    // Pattern counts for the current grid, seen from this bot's side
+    EvalFeatures extractFeatures() {
+        return withShape([&](auto shape) {
+            EvalFeatures f = {};
+            for (int r = 0; r < shape.rows; ++r) {
+                for (int c = 0; c < shape.cols; ++c) {
+                    char symbol = grid.getCell(r, c);
+                    if (symbol == ' ') continue;
+                    bool own = (symbol == botSymbol);
+                    (own ? f.ownCenter : f.oppCenter) += centerBonus(shape, r, c);
+
+                    int patterns[4];
+                    classifyLines(shape, r, c, symbol, patterns);
+                    for (int pattern : patterns) {
+                        if (pattern != PATTERN_NONE) (own ? f.own : f.opp)[pattern]++;
+                    }
+                }
+            }
+            return f;
+        });
+    }
+
+    int evaluate() {
+        return withShape([&](auto shape) { return evaluateGrid(shape); });
+    }
+
+    // Nodes searched by the last makeMove()
+    long long getLastNodes() const { return nodeCount; }
+
+    int getLastRow() const { return lastRow; }
+    int getLastCol() const { return lastCol; }
+
+    // The count best moves for side in the current position, best first,
+    // searched depth plies deep (the move plus depth - 1 replies)
+    std::vector<AnalysisLine> analyze(char side, int count, int depth) {
+        nodeCount = 0;
+        clockRunning = timeUp = false; // A move that ran out of time leaves timeUp set; analysis has no limits
+        borrowContext(std::max(depth, searchDepth + 1));
+        std::vector<AnalysisLine> lines = withShape([&](auto shape) { return analyzeMoves(shape, side, count, depth); });
+        context = nullptr;
+        return lines;
+    }
+
+    // Whether a search score means k in a row is forced
+    static bool isWinScore(int score) { return abs(score) >= SCORE_WIN; }
+
+    char getSymbol() const { return botSymbol; }
+    const EvalWeights &getWeights() const { return weights; }
+    int getEvalNoise() const { return noiseAmplitude; }
+    uint64_t getNoiseSeed() const { return noiseSeed; }
+    TranspositionTable *getTable() const { return table; }
+};
+
+// Runs BotManager::analyze in a background thread on a copy of the grid,
+// sharing the bot's transposition table, so a GUI can keep its loop running
+// and poll for the result
+class HintService {
+private:
+    std::unique_ptr<Grid> snapshot;
+    std::thread worker;
+    std::atomic<bool> finished;
+    std::vector<AnalysisLine> result;
+    int snapshotMoves; // Grid moves when the hint was asked for
+
+public:
+    HintService() : finished(false), snapshotMoves(-1) {}
+    ~HintService() {
+        if (worker.joinable()) worker.join();
+    }
+
+    bool isRunning() const { return worker.joinable(); }
+
+    // Start analysing for side, unless a hint is still being computed
+    bool start(const BotManager &bot, Grid &grid, char side, int count, int depth) {
+        if (isRunning()) return false;
+        snapshot.reset(new Grid(grid));
+        snapshotMoves = grid.getMoveCount();
+        finished = false;
+        char symbol = bot.getSymbol();
+        EvalWeights weights = bot.getWeights();
+        TranspositionTable *table = bot.getTable();
+        int noise = bot.getEvalNoise();
+        uint64_t noiseSeed = bot.getNoiseSeed();
+        worker = std::thread([this, symbol, weights, table, noise, noiseSeed, side, count, depth]() {
+            // Same symbol, table and evaluation noise as the bot, so its entries match
+            BotManager analyst(*snapshot, symbol, weights, table);
+            analyst.setEvalNoise(noise, noiseSeed);
+            analyst.setVerbose(false);
+            result = analyst.analyze(side, count, depth);
+            finished = true;
+        });
+        return true;
+    }
+
+    // Once the hint is ready, move it to lines and return true. A hint for a
+    // position the grid has since left is dropped.
+    bool poll(Grid &grid, std::vector<AnalysisLine> &lines) {
+        if (!isRunning() || !finished) return false;
+        worker.join();
+        if (grid.getMoveCount() != snapshotMoves) return false;
+        lines.swap(result);
+        return true;
+    }
+};
+
+#endif
@@ -2,762 +2,256 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <ctime>
-#include <limits>
-#include <set>
+#include <chrono>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "engine.h"
+#include "infinite.h"
+#include "record.h"
+#include "snapshot.h"
+#include "views.h"
+#include "timecontrol.h"
+#include "histogram.h"
 
 using namespace std;
 
-const int CELL_SIZE = 40;
-const int BUTTON_WIDTH = 150;
-const int BUTTON_HEIGHT = 50;
-
-// Window Manager Class
-class WindowManager {
-public:
-    static void initCenteredWindow(int windowWidth, int windowHeight, const char *title) {
-        int screenWidth = 2560;  // 2K Screen Width
-        int screenHeight = 1600; // 2K Screen Height
-
-        // Adjust for centering
-        int x = (screenWidth - windowWidth) / 2 - 610;
-        int y = (screenHeight - windowHeight) / 2 - 410;
-
-        initwindow(windowWidth, windowHeight, title, x, y);
-    }
-
-    static void setupMenuWindow() {
-        const int menuWidth = 800;
-        const int menuHeight = 600;
-        initCenteredWindow(menuWidth, menuHeight, "Tic Tac Toe Menu");
-    }
-
-    static void setupGameModeWindow() {
-        const int modeWidth = 800;
-        const int modeHeight = 600;
-        initCenteredWindow(modeWidth, modeHeight, "Select Game Mode");
-    }
-
-    static void setupGameWindow(int rows, int cols) {
-        const int extraHeight = 150; // Space for player names above the grid
-        const int gameWidth = cols * CELL_SIZE + 40; // Extra margin
-        const int gameHeight = rows * CELL_SIZE + extraHeight + 40; // Extra margin
-        initCenteredWindow(gameWidth, gameHeight, "Tic Tac Toe Game");
+const int HINT_COUNT = 3; // Moves shown by a hint
+const int HINT_DEPTH = 3; // Plies searched for a hint
+const int MAX_ROWS = 19;  // Largest board the menu offers
+const int MAX_COLS = 30;
+const char *const WINDOW_TITLE = "Tic Tac Toe";
+const char *const SAVED_GAME_PATH = "savedgame.tts"; // Game in progress, picked up by the next run
+const chrono::milliseconds SAVE_INTERVAL(1000);      // Longest the saved clock lags behind the real one
+
+// Where the time of a game's frames goes. Press T during a game to print it;
+// it is also printed when the game ends.
+struct FrameTimings {
+    LatencyHistogram clickToFrame; // Mouse click seen to the new frame on the window
+    LatencyHistogram redraw;       // Clearing the frame and drawing the grid
+    LatencyHistogram winCheck;     // checkWinner and isFull after a move
+    LatencyHistogram present;      // Putting the frame on the window
+
+    void print(ostream &out) const {
+        out << "Frame timings:" << endl;
+        clickToFrame.print(out, "  click to frame");
+        redraw.print(out, "  clear + drawGrid");
+        winCheck.print(out, "  win check");
+        present.print(out, "  present");
     }
 };
 
-// Class to manage the grid
-class Grid {
+// Platform layer: puts the frames of the software renderer on the graphics.h
+// window. On Windows the whole frame is copied to the window in one
+// SetDIBitsToDevice call; elsewhere the pixels that changed since the last
+// frame are drawn as runs of graphics.h lines.
+class WindowPresenter : public FrameSink {
 private:
-    int rows, cols;
-    vector<vector<char>> grid;
-    const int offsetX = 20;  // Horizontal offset
-    const int offsetY = 100; // Vertical offset for player names
+    string title;
+    vector<uint32_t> shown; // Frame on the window, for the graphics.h fallback
+#ifdef _WIN32
+    HWND window = nullptr;
+#endif
 
 public:
-    Grid(int n, int m) : rows(n), cols(m) {
-        grid.resize(rows, vector<char>(cols, ' '));
-    }
-
-    void drawWinningLine(int startRow, int startCol, int endRow, int endCol) {
-    int startX = offsetX + startCol * CELL_SIZE + CELL_SIZE / 2;
-    int startY = offsetY + startRow * CELL_SIZE + CELL_SIZE / 2;
-    int endX = offsetX + endCol * CELL_SIZE + CELL_SIZE / 2;
-    int endY = offsetY + endRow * CELL_SIZE + CELL_SIZE / 2;
-
-    setcolor(RED);                 // Set the line color to red
-    setlinestyle(SOLID_LINE, 0, 3); // Use a solid, thick line
-    line(startX, startY, endX, endY); // Draw the line
-    setlinestyle(SOLID_LINE, 0, 1);
-}
-    
-    void drawGrid() {
-        setcolor(WHITE);
-        for (int i = 0; i <= cols; ++i) {
-            line(offsetX + i * CELL_SIZE, offsetY, offsetX + i * CELL_SIZE, offsetY + rows * CELL_SIZE);
+    // A new window was opened; it starts black
+    void attach(const char *windowTitle, int width, int height) {
+        title = windowTitle;
+        shown.assign((size_t)width * height, PIXEL_BLACK);
+#ifdef _WIN32
+        window = nullptr;
+#endif
+    }
+
+    void show(const uint32_t *pixels, int width, int height) override {
+#ifdef _WIN32
+        if (!window) window = FindWindowA(nullptr, title.c_str());
+        if (window) {
+            BITMAPINFO info = {};
+            info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+            info.bmiHeader.biWidth = width;
+            info.bmiHeader.biHeight = -height; // Rows top to bottom
+            info.bmiHeader.biPlanes = 1;
+            info.bmiHeader.biBitCount = 32;
+            info.bmiHeader.biCompression = BI_RGB;
+            HDC dc = GetDC(window);
+            SetDIBitsToDevice(dc, 0, 0, width, height, 0, 0, 0, height, pixels, &info, DIB_RGB_COLORS);
+            ReleaseDC(window, dc);
+            return;
         }
-        for (int i = 0; i <= rows; ++i) {
-            line(offsetX, offsetY + i * CELL_SIZE, offsetX + cols * CELL_SIZE, offsetY + i * CELL_SIZE);
-        }
-        drawSymbols();
-    }
-
-    void drawSymbols() {
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                if (grid[i][j] != ' ') {
-                    drawSymbol(i, j, grid[i][j]);
+#endif
+        if (shown.size() != (size_t)width * height) shown.assign((size_t)width * height, PIXEL_BLACK);
+        for (int y = 0; y < height; ++y) {
+            const uint32_t *row = pixels + (size_t)y * width;
+            uint32_t *old = &shown[(size_t)y * width];
+            for (int x = 0; x < width;) {
+                if (row[x] == old[x]) {
+                    x++;
+                    continue;
                 }
+                int end = x + 1;
+                while (end < width && row[end] == row[x] && old[end] != row[x]) end++;
+                uint32_t p = row[x];
+                setcolor(COLOR(p >> 16 & 0xFF, p >> 8 & 0xFF, p & 0xFF));
+                line(x, y, end - 1, y);
+                for (int i = x; i < end; ++i) old[i] = p;
+                x = end;
             }
         }
     }
-
-    void clearGrid() {
-        for (auto &row : grid) {
-            fill(row.begin(), row.end(), ' '); // Reset each cell to ' '
-        }
-    }
-
-    void drawSymbol(int row, int col, char symbol) {
-        int x = offsetX + col * CELL_SIZE + CELL_SIZE / 2;
-        int y = offsetY + row * CELL_SIZE + CELL_SIZE / 2;
-
-        if (symbol == 'O') {
-            setcolor(LIGHTCYAN);
-        } else {
-            setcolor(RED);
-        }
-
-        settextstyle(SIMPLEX_FONT, HORIZ_DIR, 2);
-        string sym(1, symbol);
-        outtextxy(x - 10, y - 10, (char *)sym.c_str());
-    }
-
-    bool isCellEmpty(int row, int col) {
-        return grid[row][col] == ' ';
-    }
-
-    void setCell(int row, int col, char symbol) {
-        grid[row][col] = symbol;
-    }
-
-    char getCell(int row, int col) {
-        return grid[row][col];
-    }
-
-    int getRows() { return rows; }
-    int getCols() { return cols; }
-
-    bool isFull() {
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                if (grid[i][j] == ' ') return false;
-            }
-        }
-        return true;
-    }
 };
 
-// Class to manage players
-class PlayerManager {
+// Window Manager Class
+class WindowManager {
 private:
-    char currentPlayer;
-
-public:
-    PlayerManager() : currentPlayer('O') {}
-
-    char getCurrentPlayer() {
-        return currentPlayer;
+    static WindowPresenter &presenter() {
+        static WindowPresenter windowPresenter;
+        return windowPresenter;
     }
 
-    void switchPlayer() {
-        currentPlayer = (currentPlayer == 'O') ? 'X' : 'O';
-    }
-};
-
-struct WinSequence {
-    bool hasWinner;
-    int startRow, startCol;
-    int endRow, endCol;
-};
-
-// Class to manage game logic
-class GameLogic {
-private:
-    Grid &grid;
 public:
-    GameLogic(Grid &g) : grid(g) {}
-
-    // Return a WinSequence structure for the winning sequence
-    WinSequence checkWinner(int row, int col) {
-        char symbol = grid.getCell(row, col);
-        int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
-
-        for (auto &dir : directions) {
-            int count = 1;
-            int startRow = row, startCol = col;
-            int endRow = row, endCol = col;
-
-            // Check forward direction
-            for (int i = 1; i < 5; ++i) {
-                int newRow = row + i * dir[0];
-                int newCol = col + i * dir[1];
-                if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols() &&
-                    grid.getCell(newRow, newCol) == symbol) {
-                    count++;
-                    endRow = newRow;
-                    endCol = newCol;
-                } else {
-                    break;
-                }
-            }
-
-            // Check backward direction
-            for (int i = 1; i < 5; ++i) {
-                int newRow = row - i * dir[0];
-                int newCol = col - i * dir[1];
-                if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols() &&
-                    grid.getCell(newRow, newCol) == symbol) {
-                    count++;
-                    startRow = newRow;
-                    startCol = newCol;
-                } else {
-                    break;
-                }
-            }
-
-            if (count >= 5) {
-                return {true, startRow, startCol, endRow, endCol};
-            }
-        }
-
-        return {false, -1, -1, -1, -1};
-    }
-};
-
-// Class to manage the game menu
-class GameMenu {
-public:
-    static void drawGameModeMenu(bool redraw) {
-        if (redraw) {
-            cleardevice();
-            int screenWidth = getmaxx();
-            int screenHeight = getmaxy();
-            int centerX = screenWidth / 2;
-
-            setcolor(WHITE);
-            settextstyle(SIMPLEX_FONT, HORIZ_DIR, 2);
-
-            // Draw buttons for game modes
-            drawButton(centerX - BUTTON_WIDTH - 20, 200, "Player vs Player");
-            drawButton(centerX + 20, 200, "Player vs Bot");
+    // Frame every screen is drawn into, sized to the current window
+    static SoftwareRenderer &screen() {
+        static SoftwareRenderer frame(800, 600, &presenter());
+        return frame;
+    }
+
+    // Show what was drawn. Every 250 ms the whole frame is shown again, in
+    // case the window was covered and lost its contents.
+    static void present() {
+        static chrono::steady_clock::time_point lastRepaint;
+        auto now = chrono::steady_clock::now();
+        if (now - lastRepaint >= chrono::milliseconds(250)) {
+            screen().repaint();
+            lastRepaint = now;
+        } else {
+            screen().present();
         }
     }
 
-    static void drawMenu(int rows, int cols) {
-        int screenWidth = getmaxx();
-        int screenHeight = getmaxy();
-        int centerX = screenWidth / 2;
-        int centerY = screenHeight / 2;
-
-        // Draw rows and columns text
-        setcolor(WHITE);
-        settextstyle(SIMPLEX_FONT, HORIZ_DIR, 2);
-        string rowText = "Rows: " + to_string(rows);
-        string colText = "Cols: " + to_string(cols);
-        outtextxy(centerX - textwidth((char *)rowText.c_str()) / 2, centerY - 120, (char *)rowText.c_str());
-        outtextxy(centerX - textwidth((char *)colText.c_str()) / 2, centerY - 70, (char *)colText.c_str());
-
-        // Recalculate positions
-        int leftX = centerX - BUTTON_WIDTH - 40;  // Left side for Rows
-        int rightX = centerX + 40;               // Right side for Cols
-
-        // Buttons for Rows
-        drawButton(leftX, centerY - 40, "Rows +"); // Top left
-        drawButton(leftX, centerY + 40, "Rows -"); // Bottom left
-
-        // Buttons for Cols
-        drawButton(rightX, centerY - 40, "Cols +"); // Top right
-        drawButton(rightX, centerY + 40, "Cols -"); // Bottom right
-
-        // Start Game button
-        drawButton(centerX - BUTTON_WIDTH / 2, centerY + 150, "Start Game");
-    }
-
-    static void drawButton(int x, int y, const char *label) {
-        setcolor(WHITE);
-        setfillstyle(SOLID_FILL, BLACK);
-        bar(x, y, x + BUTTON_WIDTH, y + BUTTON_HEIGHT);
-        rectangle(x, y, x + BUTTON_WIDTH, y + BUTTON_HEIGHT);
-        settextstyle(SIMPLEX_FONT, HORIZ_DIR, 2);
-        int textWidth = textwidth((char *)label);
-        int textHeight = textheight((char *)label);
-        outtextxy(x + (BUTTON_WIDTH - textWidth) / 2, y + (BUTTON_HEIGHT - textHeight) / 2, (char *)label);
-    }
-
-    static void drawTimerMenu() {
-        int centerX = getmaxx() / 2;
-
-        setcolor(WHITE);
-        settextstyle(SIMPLEX_FONT, HORIZ_DIR, 2);
-
-        // Draw buttons for timer options
-        drawButton(centerX - BUTTON_WIDTH, 200, "10 Seconds");
-        drawButton(centerX + 10, 200, "30 Seconds");
-        drawButton(centerX - BUTTON_WIDTH / 2, 300, "60 Seconds");
-
-        // Add a title
-        string title = "Select Timer Mode";
-        settextstyle(SIMPLEX_FONT, HORIZ_DIR, 3);
-        outtextxy(centerX - 120, 100, (char*)title.c_str());
-        cout << "Me may beo" << endl;
-    }
-
-    static void drawNameInputMenu(const string &player1Name, const string &player2Name, int currentName, bool vsBot) {
-        cleardevice();
-        int screenWidth = getmaxx();
-        int centerX = screenWidth / 2;
-
-        setcolor(WHITE);
-        settextstyle(SIMPLEX_FONT, HORIZ_DIR, 2);
-
-        // Display current name being edited
-        string promptText = (currentName == 1) ? "Enter Player 1's Name(5 characters only):" : (vsBot ? "Bot's Name: Bot" : "Enter Player 2's Name(5 characters only):");
-        outtextxy(centerX - 200, 100, (char *)promptText.c_str());
+    // Open the one window every scene is drawn in: as large as the biggest
+    // board needs, but no larger than the screen, and centered on it
+    static void openWindow() {
+        int screenWidth = getmaxwidth();
+        int screenHeight = getmaxheight();
+        int windowWidth = max(MENU_WIDTH, min(MAX_COLS * CELL_SIZE + 40, screenWidth - 80));
+        int windowHeight = max(MENU_HEIGHT, min(MAX_ROWS * CELL_SIZE + 190, screenHeight - 120)); // Room for the taskbar and title bar
 
-        // Show names entered so far
-        string player1Text = "Player 1: " + player1Name;
-        string player2Text = vsBot ? "Player 2: Bot" : "Player 2: " + player2Name;
-
-        outtextxy(centerX - 200, 200, (char *)player1Text.c_str());
-        outtextxy(centerX - 200, 250, (char *)player2Text.c_str());
-
-        // Instructions
-        string instructionText = "Type the name and press ENTER to continue.";
-        outtextxy(centerX - 250, 400, (char *)instructionText.c_str());
+        initwindow(windowWidth, windowHeight, WINDOW_TITLE, max(0, (screenWidth - windowWidth) / 2), max(0, (screenHeight - windowHeight) / 2));
+        presenter().attach(WINDOW_TITLE, windowWidth, windowHeight);
+        screen().resize(windowWidth, windowHeight);
     }
+};
 
-};  
-    // Function to display the winner
-    void displayWinner(const string &playerName) {
-    setcolor(YELLOW);
-    settextstyle(SIMPLEX_FONT, HORIZ_DIR, 3);
-    
-    // Create winner message with the player's name
-    string winnerMsg = playerName + " Wins!";
-    
-    // Calculate screen and text dimensions
-    int screenWidth = getmaxx();
-    int screenHeight = getmaxy();
-    int textWidth = textwidth((char *)winnerMsg.c_str());
-    int textHeight = textheight((char *)winnerMsg.c_str());
-    
-    // Center the message on the screen
-    int x = (screenWidth - textWidth) / 2;
-    int y = (screenHeight - textHeight) / 2;
-    
-    // Display the message
-    outtextxy(x, y, (char *)winnerMsg.c_str());
+// Function to display the winner
+void displayWinner(const string &playerName) {
+    drawCenteredMessage(WindowManager::screen(), playerName + " Wins!");
+    WindowManager::present();
     delay(3000);
 }
 
-
 // Function to display a draw message
 void displayDrawMessage() {
-    setcolor(YELLOW);
-    settextstyle(SIMPLEX_FONT, HORIZ_DIR, 3);
-    string drawMsg = "It's a Draw!";
-    int screenWidth = getmaxx();
-    int screenHeight = getmaxy();
-    int textWidth = textwidth((char *)drawMsg.c_str());
-    int textHeight = textheight((char *)drawMsg.c_str());
-    int x = (screenWidth - textWidth) / 2;
-    int y = (screenHeight - textHeight) / 2;
-    outtextxy(x, y, (char *)drawMsg.c_str());
+    drawCenteredMessage(WindowManager::screen(), "It's a Draw!");
+    WindowManager::present();
     delay(3000);
 }
 
-// BotManager class for bot strategy and decision making
-class BotManager {
-private:
-    Grid &grid;
-    char botSymbol;
-    GameLogic gameLogic;
-    char opponentSymbol;
-    int lastRow, lastCol;
-
-    // Evaluate the overall grid state
-    int evaluateGrid() {
-        int score = 0;
-
-        // Evaluate each cell
-        for (int r = 0; r < grid.getRows(); ++r) {
-            for (int c = 0; c < grid.getCols(); ++c) {
-                if (grid.getCell(r, c) == botSymbol) {
-                    score += evaluatePosition(r, c, botSymbol);
-                } else if (grid.getCell(r, c) == opponentSymbol) {
-                    score -= evaluatePosition(r, c, opponentSymbol) * 2; // Penalize opponent progress
-                }
-            }
-        }
-        return score;
-    }
-
-    // Evaluate a single position for a specific symbol
-   int evaluatePosition(int row, int col, char symbol) {
-    int score = 0;
-
-    // Reward moves closer to the center
-    int centerRow = grid.getRows() / 2;
-    int centerCol = grid.getCols() / 2;
-    score += 50 - abs(centerRow - row) - abs(centerCol - col);
-
-    // Add existing logic for consecutive counts
-    score += countConsecutive(row, col, 0, 1, symbol);  // Horizontal
-    score += countConsecutive(row, col, 1, 0, symbol);  // Vertical
-    score += countConsecutive(row, col, 1, 1, symbol);  // Diagonal 
-    score += countConsecutive(row, col, -1, 1, symbol); // Diagonal 
-
-    return score;
-}
-
-int countSequence(int row, int col, int rowDir, int colDir, char symbol) {
-    int count = 0;
-
-    // Count consecutive symbols in one direction
-    for (int i = 1; i < 5; ++i) {
-        int newRow = row + i * rowDir;
-        int newCol = col + i * colDir;
-        if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols()) {
-            if (grid.getCell(newRow, newCol) == symbol) {
-                count++;
-            } else {
-                break; // Stop counting if blocked by an opponent or out of bounds
-            }
-        }
-    }
-
-    // Count consecutive symbols in the opposite direction
-    for (int i = 1; i < 5; ++i) {
-        int newRow = row - i * rowDir;
-        int newCol = col - i * colDir;
-        if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols()) {
-            if (grid.getCell(newRow, newCol) == symbol) {
-                count++;
-            } else {
-                break; // Stop counting if blocked by an opponent or out of bounds
-            }
-        }
-    }
-
-    return count; // Return the total consecutive symbols
-}
-
-
-    // Count consecutive symbols in a direction
-    int countConsecutive(int row, int col, int rowDir, int colDir, char symbol) {
-        int count = 0, openEnds = 0;
-
-        // Count consecutive symbols in one direction
-        for (int i = 1; i < 5; ++i) {
-            int newRow = row + i * rowDir;
-            int newCol = col + i * colDir;
-            if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols()) {
-                if (grid.getCell(newRow, newCol) == symbol) {
-                    count++;
-                } else if (grid.isCellEmpty(newRow, newCol)) {
-                    openEnds++;
-                    break;
-                } else {
-                    break;
-                }
-            }
-        }
-
-        // Count consecutive symbols in the opposite direction
-        for (int i = 1; i < 5; ++i) {
-            int newRow = row - i * rowDir;
-            int newCol = col - i * colDir;
-            if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols()) {
-                if (grid.getCell(newRow, newCol) == symbol) {
-                    count++;
-                } else if (grid.isCellEmpty(newRow, newCol)) {
-                    openEnds++;
-                    break;
-                } else {
-                    break;
-                }
-            }
-        }
-
-        // Scoring adjustments for defensiveness
-        if (count >= 4) return (symbol == botSymbol ? 1000 : -1500);  // Winning or critical threat
-        if (count == 3 && openEnds == 2) return (symbol == botSymbol ? 700 : -900);  // Open-ended 3 (very dangerous)
-        if (count == 3 && openEnds == 1) return (symbol == botSymbol ? 500 : -600);  // Blocked 3 (important to block)
-        if (count == 2 && openEnds == 2) return (symbol == botSymbol ? 200 : -200);  // Open-ended 2 (potential to grow)
-        if (count == 2 && openEnds == 1) return (symbol == botSymbol ? 100 : -100);  // Blocked 2 (minor threat)
-        
-        return 0;
-    }
-
-    int minimax(int depth, bool isMaximizing, int alpha, int beta) {
-    if (grid.isFull() || depth == 0) {
-        return evaluateGrid(); // Evaluate the grid if at terminal depth or full grid
-    }
-
-    vector<pair<int, int>> candidateMoves = getCandidateMoves();
-
-    if (isMaximizing) {
-        int bestScore = std::numeric_limits<int>::min();
-        for (const auto &move : candidateMoves) {
-            int r = move.first, c = move.second;
-            grid.setCell(r, c, botSymbol); // Simulate bot's move
-            int score = minimax(depth - 1, false, alpha, beta); // Recursively minimize
-            grid.setCell(r, c, ' '); // Undo the move
-            bestScore = std::max(bestScore, score);
-            alpha = std::max(alpha, bestScore);
-            if (beta <= alpha) break; // Alpha-beta pruning
-        }
-        return bestScore;
-    } else {
-        int bestScore = std::numeric_limits<int>::max();
-        for (const auto &move : candidateMoves) {
-            int r = move.first, c = move.second;
-            grid.setCell(r, c, opponentSymbol); // Simulate opponent's move
-            int score = minimax(depth - 1, true, alpha, beta); // Recursively maximize
-            grid.setCell(r, c, ' '); // Undo the move
-            bestScore = std::min(bestScore, score);
-            beta = std::min(beta, bestScore);
-            if (beta <= alpha) break; // Alpha-beta pruning
-        }
-        return bestScore;
-    }
-}
-
-
-    // Check if the bot or opponent can win in the next move
-    bool canWinNextMove(char symbol, int &winRow, int &winCol) {
-    for (int r = 0; r < grid.getRows(); ++r) {
-        for (int c = 0; c < grid.getCols(); ++c) {
-            if (grid.isCellEmpty(r, c)) {
-                grid.setCell(r, c, symbol); // Simulate bot's move
-                if (checkWinner(r, c)) {
-                    grid.setCell(r, c, ' '); // Undo move
-                    winRow = r;
-                    winCol = c;
-                    return true; // Winning move found
-                }
-                grid.setCell(r, c, ' '); // Undo move
-            }
-        }
-    }
-    return false; // No winning move found
-}
-
-    bool checkWinner(int row, int col) {
-    // Call the updated checkWinner from GameLogic
-    WinSequence winSeq = gameLogic.checkWinner(row, col);
-
-    if (winSeq.hasWinner) {
-        // Highlight the winning sequence on the grid
-        grid.drawWinningLine(winSeq.startRow, winSeq.startCol, winSeq.endRow, winSeq.endCol);
-        return true; // Winner detected
-    }
-    return false; // No winner
-}
-
-    // Get candidate moves near occupied cells
-    vector<pair<int, int>> getCandidateMoves() {
-        set<pair<int, int>> candidates;
-
-        for (int r = 0; r < grid.getRows(); ++r) {
-            for (int c = 0; c < grid.getCols(); ++c) {
-                if (grid.getCell(r, c) != ' ') {
-                    for (int dr = -1; dr <= 1; ++dr) {
-                        for (int dc = -1; dc <= 1; ++dc) {
-                            int newRow = r + dr;
-                            int newCol = c + dc;
-                            if (newRow >= 0 && newRow < grid.getRows() &&
-                                newCol >= 0 && newCol < grid.getCols() &&
-                                grid.isCellEmpty(newRow, newCol)) {
-                                candidates.insert({newRow, newCol});
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        return vector<pair<int, int>>(candidates.begin(), candidates.end());
-    }
-
-    // Detect and block the strongest threat from the opponent
-  bool detectAndBlockThreat(char symbol, int &threatRow, int &threatCol) {
-    bool fourConsecutiveBlocked = false;
-
-    for (int r = 0; r < grid.getRows(); ++r) {
-        for (int c = 0; c < grid.getCols(); ++c) {
-            if (grid.isCellEmpty(r, c)) {
-                // Simulate placing the player's symbol in this cell
-                grid.setCell(r, c, symbol);
-
-                // **1. Check for 4 consecutive symbols**
-                int directions[4][2] = {
-                    {0, 1},  // Horizontal
-                    {1, 0},  // Vertical
-                    {1, 1},  // Diagonal
-                    {-1, 1}  // Anti-diagonal
-                };
-
-                for (auto &dir : directions) {
-                    if (countSequence(r, c, dir[0], dir[1], symbol) >= 4) {
-                        // Debugging output
-                        cout << "Detected 4-symbol threat at (" << r << ", " << c << ")\n";
-
-                        // Block the 4-symbol threat
-                        grid.setCell(r, c, ' '); // Undo the move
-                        threatRow = r;
-                        threatCol = c;
-                        return true; // Immediately block and stop further evaluation
-                    }
-                }
-
-                // **2. Check for open-ended 3-symbol threats**
-                if (!fourConsecutiveBlocked && countOpenConsecutive(r, c, symbol) >= 3) {
-                    // Debugging output
-                    cout << "Detected open-ended 3-symbol threat at (" << r << ", " << c << ")\n";
-
-                    // Tentatively block the 3-symbol threat (if no 4-symbol threat exists)
-                    grid.setCell(r, c, ' '); // Undo the move
-                    threatRow = r;
-                    threatCol = c;
-
-                    // Do not immediately return, continue to ensure no 4-symbol threats exist
-                    fourConsecutiveBlocked = true;
-                }
-
-                grid.setCell(r, c, ' '); // Undo the move
-            }
-        }
-    }
-
-    // If a 3-symbol threat was found and no 4-symbol threat exists, block it
-    return fourConsecutiveBlocked;
-}
-
-
-int countOpenConsecutive(int row, int col, char symbol) {
-    int directions[4][2] = {
-        {0, 1},  // Horizontal
-        {1, 0},  // Vertical
-        {1, 1},  // Diagonal 
-        {-1, 1}  // Diagonal 
-    };
-
-    int maxConsecutive = 0;
-
-    for (auto &dir : directions) {
-        int consecutive = 0;
-        bool openStart = false, openEnd = false;
-
-        // Check forward direction
-        for (int i = 1; i < 5; ++i) {
-            int newRow = row + i * dir[0];
-            int newCol = col + i * dir[1];
-            if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols()) {
-                if (grid.getCell(newRow, newCol) == symbol) {
-                    consecutive++;
-                } else if (grid.isCellEmpty(newRow, newCol)) {
-                    openEnd = true;
-                    break;
-                } else {
-                    break;
-                }
-            }
-        }
-
-        // Check backward direction
-        for (int i = 1; i < 5; ++i) {
-            int newRow = row - i * dir[0];
-            int newCol = col - i * dir[1];
-            if (newRow >= 0 && newRow < grid.getRows() && newCol >= 0 && newCol < grid.getCols()) {
-                if (grid.getCell(newRow, newCol) == symbol) {
-                    consecutive++;
-                } else if (grid.isCellEmpty(newRow, newCol)) {
-                    openStart = true;
-                    break;
-                } else {
-                    break;
-                }
-            }
-        }
+// Screens of the application. They all draw in the same window; each one
+// runs until the player picks the next.
+enum Scene {
+    SCENE_BOARD_MENU, // Grid size and win length
+    SCENE_TIMER_MENU,
+    SCENE_MODE_MENU,  // Player vs Player or vs Bot
+    SCENE_NAMES,
+    SCENE_GAME,
+    SCENE_INFINITE,   // Game on the unbounded board
+    SCENE_EXIT
+};
 
-        // Consider the sequence valid if it's open on at least one end
-        if (openStart || openEnd) {
-            maxConsecutive = max(maxConsecutive, consecutive);
+// Main application class
+class Application {
+private:
+    // Settings picked in the menus
+    int rows = 10, cols = 10;
+    int winLength = DEFAULT_WIN_LENGTH; // Stones in a row that win
+    string player1Name = "", player2Name = "";
+    bool vsBot = false;
+    int botLevel = BOT_LEVEL_COUNT - 1; // Index in BOT_LEVELS
+    bool infinite = false; // Unbounded board instead of rows x cols
+    TimeControl timeControl = TimeControl::perMove(30000); // Default timer mode
+
+    // Game left unfinished by an earlier run, played on instead of a new one
+    bool resuming = false;
+    GameSnapshot savedGame = {};
+    vector<char> savedCells; // Its grid block
+
+    // "Time Left: 29.3s" for a limit per move, both clocks otherwise
+    static string clockText(const GameClock &clock, char current) {
+        if (clock.getControl().mode == TIME_PER_MOVE) return "Time Left: " + clock.format(current);
+        return "O " + clock.format('O') + "  X " + clock.format('X');
+    }
+
+    // Seed of the bot's evaluation noise for a new game, printed so the
+    // game can be played again the same way
+    uint64_t newBotSeed() const {
+        uint64_t seed = (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+        cout << "Bot level " << BOT_LEVELS[botLevel].name << ", seed " << seed << endl;
+        return seed;
+    }
+
+    // Pick up the game an earlier run left in SAVED_GAME_PATH, clock and
+    // all; the menus are skipped but the names are asked for again
+    bool loadSavedGame() {
+        SnapshotReader reader;
+        const GameSnapshot *saved;
+        const char *storage;
+        if (!reader.open(SAVED_GAME_PATH) || !reader.nextGame(saved, storage)) return false;
+        if (!isRestorable(*saved, storage) || saved->over || saved->hasClock != 1 || saved->rows > MAX_ROWS ||
+            saved->cols > MAX_COLS || saved->botSymbol == 'O' || (saved->botSymbol == 'X' && saved->botLevel < 0)) {
+            cout << "Ignoring " << SAVED_GAME_PATH << ", it holds no game to go on with." << endl;
+            return false;
         }
+        savedGame = *saved;
+        savedCells.assign(storage, storage + saved->storageBytes);
+        rows = saved->rows;
+        cols = saved->cols;
+        winLength = saved->winLength;
+        vsBot = saved->botSymbol == 'X';
+        if (vsBot) botLevel = saved->botLevel;
+        infinite = false;
+        const ClockState &c = saved->clock;
+        timeControl = {(TimeMode)c.mode, c.mainMs, c.incrementMs, c.periodMs, c.periods};
+        resuming = true;
+        cout << "Resuming the game saved in " << SAVED_GAME_PATH << " after " << saved->moveCount << " moves." << endl;
+        return true;
     }
 
-    return maxConsecutive;
-}
-
-public:
-    BotManager(Grid &g, char symbol)
-        : grid(g), botSymbol(symbol), gameLogic(g), opponentSymbol(symbol == 'O' ? 'X' : 'O'), lastRow(-1), lastCol(-1) {}
-
-    void makeMove() {
-    int winRow, winCol;
-    int threatRow, threatCol;
-    int forkRow, forkCol;
-
-    // Check if the bot can win immediately
-    if (canWinNextMove(botSymbol, winRow, winCol)) {
-        grid.setCell(winRow, winCol, botSymbol);
-        lastRow = winRow;
-        lastCol = winCol;
-        cout << "Bot wins immediately by placing at (" << winRow << ", " << winCol << ")." << endl;
-        return;
-    }
-
-    // Check if the player has a winning move and block it
-    if (detectAndBlockThreat(opponentSymbol, threatRow, threatCol)) {
-        grid.setCell(threatRow, threatCol, botSymbol);
-        lastRow = threatRow;
-        lastCol = threatCol;
-        cout << "Bot blocks at (" << threatRow << ", " << threatCol << ")." << endl;
-        return;
+    // Write the game being played to SAVED_GAME_PATH, for loadSavedGame()
+    void saveGame(Grid &grid, PlayerManager &playerManager, const GameClock &clock, uint64_t botSeed) const {
+        SnapshotWriter writer;
+        if (!writer.open(SAVED_GAME_PATH)) return;
+        GameSnapshot saved = {0, grid.getRows(), grid.getCols(), grid.getMoveCount(), playerManager.getCurrentPlayer(),
+                              vsBot ? 'X' : ' ', 0, (char)grid.getWinLength(), 0, vsBot ? botLevel : -1, 1, botSeed,
+                              clock.saveState()};
+        writer.addGame(saved, grid);
+        writer.close();
     }
 
-    // Strategic move using Minimax
-    int bestScore = std::numeric_limits<int>::min();
-    int bestRow = -1, bestCol = -1;
-    vector<pair<int, int>> candidateMoves = getCandidateMoves();
-
-    for (const auto &move : candidateMoves) {
-        int r = move.first, c = move.second;
-        grid.setCell(r, c, botSymbol);
-        int score = minimax(3, false, std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
-        grid.setCell(r, c, ' '); // Undo move
-
-        if (score > bestScore) {
-            bestScore = score;
-            bestRow = r;
-            bestCol = c;
-        }
+    static Scene endGame() {
+        cout << "Game over! Press any key to exit." << endl;
+        getch(); // Wait for user input before exiting
+        return SCENE_EXIT;
     }
 
-    if (bestRow != -1 && bestCol != -1) {
-        grid.setCell(bestRow, bestCol, botSymbol);
-        lastRow = bestRow;
-        lastCol = bestCol;
-        cout << "Bot places strategically at (" << bestRow << ", " << bestCol << ")." << endl;
-    } else {
-        cout << "Bot could not find a valid move." << endl;
-    }
-}
-
-    int getLastRow() const { return lastRow; }
-    int getLastCol() const { return lastCol; }
-};
-
-
-// Main application class
-class Application {
-
-public:
-    void run() {
-        int rows = 10, cols = 10;
-        string player1Name = "", player2Name = "";
-        bool vsBot = false;
-        int timerMode = 30; // Default timer mode   
-    
-
-        // Phase 1: Menu for Grid Size
-        WindowManager::setupMenuWindow();
+    // Menu for Grid Size
+    Scene boardMenu() {
+        Renderer &screen = WindowManager::screen();
         bool redrawMenu = true;
 
         // Define button positions
-        int centerX = getmaxx() / 2;
-        int centerY = getmaxy() / 2;
+        int centerX = screen.getMaxX() / 2;
+        int centerY = screen.getMaxY() / 2;
         int leftX = centerX - BUTTON_WIDTH - 40;
         int rightX = centerX + 40;
         int rowsPlusY = centerY - 40;
@@ -766,111 +260,138 @@ public:
         int colsMinusY = centerY + 40;
         int startButtonX = centerX - BUTTON_WIDTH / 2;
         int startButtonY = centerY + 150;
+        int winButtonY = centerY - 200;
 
         while (true) {
             if (redrawMenu) {
-                cleardevice();
-                GameMenu::drawMenu(rows, cols);
+                screen.clear();
+                GameMenu::drawMenu(screen, rows, cols, winLength);
                 redrawMenu = false;
             }
+            WindowManager::present();
 
             if (ismouseclick(WM_LBUTTONDOWN)) {
                 int x = mousex();
                 int y = mousey();
                 clearmouseclick(WM_LBUTTONDOWN);
 
-                if (x >= leftX && x <= leftX + BUTTON_WIDTH && y >= rowsPlusY && y <= rowsPlusY + BUTTON_HEIGHT && rows < 19) {
+                if (x >= startButtonX && x <= startButtonX + BUTTON_WIDTH && y >= winButtonY && y <= winButtonY + BUTTON_HEIGHT) {
+                    winLength = (winLength < MAX_WIN_LENGTH) ? winLength + 1 : MIN_WIN_LENGTH;
+                    rows = max(rows, winLength);
+                    cols = max(cols, winLength);
+                    redrawMenu = true;
+                } else if (x >= leftX && x <= leftX + BUTTON_WIDTH && y >= rowsPlusY && y <= rowsPlusY + BUTTON_HEIGHT && rows < MAX_ROWS) {
                     rows++;
                     redrawMenu = true;
-                } else if (x >= leftX && x <= leftX + BUTTON_WIDTH && y >= rowsMinusY && y <= rowsMinusY + BUTTON_HEIGHT && rows > 10) {
+                } else if (x >= leftX && x <= leftX + BUTTON_WIDTH && y >= rowsMinusY && y <= rowsMinusY + BUTTON_HEIGHT && rows > winLength) {
                     rows--;
                     redrawMenu = true;
-                } else if (x >= rightX && x <= rightX + BUTTON_WIDTH && y >= colsPlusY && y <= colsPlusY + BUTTON_HEIGHT && cols < 30) {
+                } else if (x >= rightX && x <= rightX + BUTTON_WIDTH && y >= colsPlusY && y <= colsPlusY + BUTTON_HEIGHT && cols < MAX_COLS) {
                     cols++;
                     redrawMenu = true;
-                } else if (x >= rightX && x <= rightX + BUTTON_WIDTH && y >= colsMinusY && y <= colsMinusY + BUTTON_HEIGHT && cols > 10) {
+                } else if (x >= rightX && x <= rightX + BUTTON_WIDTH && y >= colsMinusY && y <= colsMinusY + BUTTON_HEIGHT && cols > winLength) {
                     cols--;
                     redrawMenu = true;
                 } else if (x >= startButtonX && x <= startButtonX + BUTTON_WIDTH && y >= startButtonY && y <= startButtonY + BUTTON_HEIGHT) {
-                    break; // Start Game 
+                    infinite = false;
+                    return SCENE_TIMER_MENU; // Start Game
+                } else if (x >= startButtonX && x <= startButtonX + BUTTON_WIDTH && y >= startButtonY + 70 && y <= startButtonY + 70 + BUTTON_HEIGHT) {
+                    infinite = true;
+                    return SCENE_TIMER_MENU; // Start on the unbounded board
                 }
             }
 
             delay(10);
         }
+    }
 
-        closegraph(); // Close the grid size menu
+    // Timer Mode Selection
+    Scene timerMenu() {
+        Renderer &screen = WindowManager::screen();
+        int centerX = screen.getMaxX() / 2;
+        int top = menuTop(screen);
+        bool redrawTimerMenu = true;
+        while (true) {
+            if (redrawTimerMenu) {
+                screen.clear();
+                GameMenu::drawTimerMenu(screen);
+                redrawTimerMenu = false;
+            }
+            WindowManager::present();
 
-        // Phase 2: Timer Mode Selection
-    WindowManager::setupMenuWindow();
-    bool redrawTimerMenu = true;
-    while (true) {
-        if (redrawTimerMenu) {
-            cleardevice();
-            GameMenu::drawTimerMenu();
-            redrawTimerMenu = false;
-        }
+            if (ismouseclick(WM_LBUTTONDOWN)) {
+                int x = mousex();
+                int y = mousey() - top;
+                clearmouseclick(WM_LBUTTONDOWN);
 
-        if (ismouseclick(WM_LBUTTONDOWN)) {
-            int x = mousex();
-            int y = mousey();
-            clearmouseclick(WM_LBUTTONDOWN);
+                if (x >= centerX - BUTTON_WIDTH && x <= centerX && y >= 200 && y <= 250) {
+                    timeControl = TimeControl::perMove(10000); // 10 seconds
+                    return SCENE_MODE_MENU;
+                } else if (x >= centerX + 10 && x <= centerX + BUTTON_WIDTH + 10 && y >= 200 && y <= 250) {
+                    timeControl = TimeControl::perMove(30000); // 30 seconds
+                    return SCENE_MODE_MENU;
+                } else if (x >= centerX - BUTTON_WIDTH / 2 && x <= centerX + BUTTON_WIDTH / 2 && y >= 300 && y <= 350) {
+                    timeControl = TimeControl::perMove(60000); // 60 seconds
+                    return SCENE_MODE_MENU;
+                } else if (x >= centerX - BUTTON_WIDTH * 3 / 2 - 20 && x <= centerX - BUTTON_WIDTH / 2 - 20 && y >= 430 && y <= 480) {
+                    timeControl = TimeControl::suddenDeath(5 * 60000); // 5 minutes each
+                    return SCENE_MODE_MENU;
+                } else if (x >= centerX - BUTTON_WIDTH / 2 && x <= centerX + BUTTON_WIDTH / 2 && y >= 430 && y <= 480) {
+                    timeControl = TimeControl::fischer(3 * 60000, 2000); // 3 minutes, 2 seconds back per move
+                    return SCENE_MODE_MENU;
+                } else if (x >= centerX + BUTTON_WIDTH / 2 + 20 && x <= centerX + BUTTON_WIDTH * 3 / 2 + 20 && y >= 430 && y <= 480) {
+                    timeControl = TimeControl::byoyomi(60000, 3, 10000); // 1 minute, then 3 periods of 10 seconds
+                    return SCENE_MODE_MENU;
+                } else {
+                    redrawTimerMenu = true; // Ensure the menu redraws if no button is clicked
+                }
+            }
 
-            if (x >= centerX - BUTTON_WIDTH && x <= centerX && y >= 200 && y <= 250) {
-                timerMode = 10; // 10 seconds
-                break;
-            } else if (x >= centerX + 10 && x <= centerX + BUTTON_WIDTH + 10 && y >= 200 && y <= 250) {
-                timerMode = 30; // 30 seconds
-                break;
-            } else if (x >= centerX - BUTTON_WIDTH / 2 && x <= centerX + BUTTON_WIDTH / 2 && y >= 300 && y <= 350) {
-                timerMode = 60; // 60 seconds
-                break;
-           } else {
-                 redrawTimerMenu = true; // Ensure the menu redraws if no button is clicked
-                    }
+            delay(10);
         }
-
-        delay(10);
     }
 
-    closegraph(); // Close the timer selection menu
-
-
-        // Phase 3: Game Mode Selection
-        WindowManager::setupGameModeWindow();
-        bool redrawGameMode = true;
+    // Game Mode Selection
+    Scene modeMenu() {
+        Renderer &screen = WindowManager::screen();
+        int centerX = screen.getMaxX() / 2;
+        int top = menuTop(screen);
+        GameMenu::drawGameModeMenu(screen);
         while (true) {
-            GameMenu::drawGameModeMenu(redrawGameMode);
-            redrawGameMode = false;
+            WindowManager::present();
 
             if (ismouseclick(WM_LBUTTONDOWN)) {
                 int x = mousex();
-                int y = mousey();
+                int y = mousey() - top;
                 clearmouseclick(WM_LBUTTONDOWN);
 
-                int centerX = getmaxx() / 2;
-
-                if (x >= centerX - BUTTON_WIDTH - 20 && x <= centerX - 20 && y >= 200 && y <= 200 + BUTTON_HEIGHT) {
+                if (x >= centerX - BUTTON_WIDTH / 2 && x <= centerX + BUTTON_WIDTH / 2 && y >= 200 && y <= 200 + BUTTON_HEIGHT) {
                     vsBot = false;
-                    break; // Player vs Player
-                } else if (x >= centerX + 20 && x <= centerX + BUTTON_WIDTH + 20 && y >= 200 && y <= 200 + BUTTON_HEIGHT) {
-                    vsBot = true;
-                    break; // Player vs Bot
-                } 
+                    return SCENE_NAMES; // Player vs Player
+                }
+                for (int level = 0; level < BOT_LEVEL_COUNT; ++level) {
+                    int left = GameMenu::levelButtonX(centerX, level);
+                    if (x >= left && x <= left + BUTTON_WIDTH && y >= 340 && y <= 340 + BUTTON_HEIGHT) {
+                        vsBot = true;
+                        botLevel = level;
+                        return SCENE_NAMES; // Player vs Bot
+                    }
+                }
             }
 
             delay(10);
         }
+    }
 
-        closegraph(); // Close the game mode selection menu
-
-        // Phase 4: Menu for Player Names
-        WindowManager::setupMenuWindow();
+    // Menu for Player Names
+    Scene nameInput() {
+        Renderer &screen = WindowManager::screen();
         int currentName = 1;
         while (true) {
             if (vsBot && currentName > 1) break; // Only one player for vs Bot mode
 
-            GameMenu::drawNameInputMenu(player1Name, player2Name, currentName, vsBot);
+            GameMenu::drawNameInputMenu(screen, player1Name, player2Name, currentName, vsBot);
+            WindowManager::present();
             if (kbhit()) {
                 char key = getch();
                 if (key == '\r') { // ENTER key to switch to next name
@@ -887,45 +408,186 @@ public:
             delay(50);
         }
         if (vsBot) player2Name = "Bot"; // Assign default name for bot
-        closegraph(); //Close the player names Menu
+        return infinite ? SCENE_INFINITE : SCENE_GAME;
+    }
 
-        // Phase 5: Game Window
-        WindowManager::setupGameWindow(rows, cols);
-        Grid grid(rows, cols);
+    // Freestyle game on the unbounded board. Games are not recorded, since
+    // record files store moves as cells of a bounded grid.
+    Scene playInfinite() {
+        SparseBoard board(winLength);
+        Renderer &screen = WindowManager::screen();
+        InfiniteView view(board, screen);
+        PlayerManager playerManager;
+        EvalWeights weights = EvalWeights::defaults();
+        weights.load("weights.txt");
+        InfiniteBot bot(board, 'X', weights);
+        if (vsBot) bot.setLevel(botLevel, newBotSeed());
+        bool gameOver = false;
+        bool redraw = true;
+        GameClock clock(timeControl);
+        clock.start('O');
+        string shownTimer;
+
+        while (!gameOver) {
+            if (redraw) {
+                screen.clear();
+                view.draw();
+                drawPlayerNames(screen, player1Name, player2Name);
+                shownTimer.clear();
+                redraw = false;
+            }
+
+            string timerText = clockText(clock, playerManager.getCurrentPlayer());
+            if (timerText != shownTimer) {
+                drawTimer(screen, timerText, 30);
+                shownTimer = timerText;
+            }
+            WindowManager::present();
+
+            if (clock.flagged(playerManager.getCurrentPlayer())) {
+                displayWinner(playerManager.getCurrentPlayer() == 'O' ? player2Name : player1Name);
+                gameOver = true;
+                break;
+            }
+
+            int row = 0, col = 0;
+            bool moved = false;
+            if (vsBot && playerManager.getCurrentPlayer() == 'X') {
+                bot.setTimeLimit(clock.moveBudgetMs('X'));
+                if (!bot.makeMove()) {
+                    cout << "Bot did not make a move." << endl;
+                    displayDrawMessage();
+                    gameOver = true;
+                    break;
+                }
+                row = bot.getLastRow();
+                col = bot.getLastCol();
+                cout << "Bot placed at (" << row << ", " << col << ")." << endl;
+                moved = true;
+            } else {
+                if (kbhit()) {
+                    int key = getch();
+                    if (key == 0) key = getch() + 256; // Arrow keys come as 0 followed by a scan code
+                    if (key == 'w' || key == 'W' || key == 256 + 72) view.scroll(-1, 0);
+                    if (key == 's' || key == 'S' || key == 256 + 80) view.scroll(1, 0);
+                    if (key == 'a' || key == 'A' || key == 256 + 75) view.scroll(0, -1);
+                    if (key == 'd' || key == 'D' || key == 256 + 77) view.scroll(0, 1);
+                    if (key == '+' || key == '=') view.zoom(8);
+                    if (key == '-') view.zoom(-8);
+                    redraw = true;
+                }
+                if (ismouseclick(WM_LBUTTONDOWN)) {
+                    int x = mousex(), y = mousey();
+                    clearmouseclick(WM_LBUTTONDOWN);
+                    if (view.cellAt(x, y, row, col) && board.isCellEmpty(row, col)) {
+                        board.makeMove(row, col, playerManager.getCurrentPlayer());
+                        moved = true;
+                    }
+                }
+            }
+
+            if (moved) {
+                view.follow(row, col);
+                redraw = true;
+                WinSequence winSeq = board.checkWinner(row, col);
+                if (!clock.endTurn()) {
+                    gameOver = true; // The move came too late
+                    displayWinner(playerManager.getCurrentPlayer() == 'O' ? player2Name : player1Name);
+                } else if (winSeq.hasWinner) {
+                    screen.clear();
+                    view.draw();
+                    drawPlayerNames(screen, player1Name, player2Name);
+                    view.drawWinningLine(winSeq);
+                    gameOver = true;
+                    displayWinner(playerManager.getCurrentPlayer() == 'O' ? player1Name : player2Name);
+                } else {
+                    playerManager.switchPlayer();
+                    clock.start(playerManager.getCurrentPlayer());
+                }
+            }
+            delay(10);
+        }
+
+        return endGame();
+    }
+
+    // Game on a rows x cols grid
+    Scene playGame() {
+        Renderer &screen = WindowManager::screen();
+        Grid grid(rows, cols, winLength);
+        GridView gridView(grid, screen);
         PlayerManager playerManager;
         GameLogic gameLogic(grid);
-        BotManager botManager(grid, 'X'); // Initialize bot
+        EvalWeights weights = EvalWeights::defaults();
+        if (weights.load("weights.txt")) {
+            cout << "Loaded bot weights from weights.txt" << endl;
+        }
+        BotManager botManager(grid, 'X', weights); // Initialize bot
+        uint64_t botSeed = 0;
+        if (vsBot) {
+            botSeed = resuming ? savedGame.botSeed : newBotSeed();
+            botManager.setLevel(botLevel, botSeed);
+        }
+        HintService hints; // Press H for the best moves of the player to move
         bool gameOver = false;
         GameMenu menu; 
         bool needRestart = true;
 
-        int countdown = timerMode; 
-        time_t startTime = time(nullptr); // Record the start time
+        GameClock clock(timeControl);
+        if (resuming) {
+            grid.restore(savedCells.data(), savedGame.moveCount);
+            playerManager.setCurrentPlayer(savedGame.currentPlayer);
+            clock.restoreState(savedGame.clock); // The turn to move goes on from its saved time
+            resuming = false;
+        }
+        if (!clock.isRunning()) clock.start(playerManager.getCurrentPlayer()); // Start the first player's clock
+        string shownTimer; // Timer text on screen, empty after a redraw
+        int savedMoves = -1; // Moves in SAVED_GAME_PATH
+        chrono::steady_clock::time_point lastSave;
+
+        FrameTimings timings;
+        chrono::steady_clock::time_point clickTime;
+        bool framePending = false; // A click was handled and its frame is not shown yet
+
+        // Append this game to the record file
+        GameRecordWriter recorder;
+        if (!recorder.open("games.ttr")) {
+            cout << "Could not open games.ttr, this game will not be recorded." << endl;
+        }
+        recorder.beginGame({rows, cols, timeControl, (unsigned char)(vsBot ? PLAYER_X_BOT : 0), FLAG_STATS, winLength});
+        for (int i = 0; i < grid.getMoveCount(); ++i) recorder.addMove(grid.getMoveRow(i), grid.getMoveCol(i)); // Resumed game
 
-        cleardevice();                               
-        grid.drawGrid(); 
+        screen.clear();
+        gridView.drawGrid(); 
        
 
         while (!gameOver) {
-            setcolor(WHITE);
-            settextstyle(SIMPLEX_FONT, HORIZ_DIR, 2);
-            outtextxy(20, 10, (char *)("Player 1: " + player1Name + " (O)").c_str());
-            outtextxy(20, 50, (char *)("Player 2: " + player2Name + " (X)").c_str());
-
-        // Display timer at the bottom-right corner
-            string timerText = "Time Left: " + to_string(countdown) + "s";
-            int timerTextWidth = textwidth((char *)timerText.c_str());
-            int timerTextHeight = textheight((char *)timerText.c_str());
-            int screenWidth = getmaxx();
-            int screenHeight = getmaxy();
-            outtextxy(screenWidth - timerTextWidth - 20, screenHeight - timerTextHeight - 20, (char *)timerText.c_str());
-
-
-            // Update the timer
-            if (time(nullptr) - startTime >= 1) { // Check if 1 second has passed
-                countdown--;
-                startTime = time(nullptr); // Reset start time for the next second
-                if (countdown == 0) {
+            // Keep the saved game up to date, so a restart can go on with it
+            if (grid.getMoveCount() != savedMoves || chrono::steady_clock::now() - lastSave >= SAVE_INTERVAL) {
+                saveGame(grid, playerManager, clock, botSeed);
+                savedMoves = grid.getMoveCount();
+                lastSave = chrono::steady_clock::now();
+            }
+            if (shownTimer.empty()) drawPlayerNames(screen, player1Name, player2Name);
+
+        // Display timer at the bottom-right corner, when the text changes
+            string timerText = clockText(clock, playerManager.getCurrentPlayer());
+            if (timerText != shownTimer) {
+                drawTimer(screen, timerText, screen.getMaxY() - screen.textHeight(2) - 20);
+                shownTimer = timerText;
+            }
+            auto presentStart = chrono::steady_clock::now();
+            WindowManager::present();
+            timings.present.recordSince(presentStart);
+            if (framePending) {
+                timings.clickToFrame.recordSince(clickTime);
+                framePending = false;
+            }
+
+
+            // Check the clock of the player to move
+            if (clock.flagged(playerManager.getCurrentPlayer())) {
+                recorder.endGame(playerManager.getCurrentPlayer() == 'O' ? 'X' : 'O');
                 if (playerManager.getCurrentPlayer() == 'O') {
                         displayWinner(player2Name); 
                     } else {
@@ -933,16 +595,32 @@ public:
                     }
                     gameOver = true;
                     break;
-                }
             }
         
 
+            // Hints run in the background; show one once it is ready
+            vector<AnalysisLine> hintLines;
+            if (hints.poll(grid, hintLines)) gridView.drawHints(hintLines);
+            bool botTurn = vsBot && playerManager.getCurrentPlayer() == 'X';
+            if (!botTurn && kbhit()) {
+                char key = getch();
+                if ((key == 'h' || key == 'H') && hints.start(botManager, grid, playerManager.getCurrentPlayer(), HINT_COUNT, HINT_DEPTH)) {
+                    cout << "Looking for a hint..." << endl;
+                }
+                if (key == 't' || key == 'T') timings.print(cout);
+            }
+
     // Bot's turn in Player vs Bot mode
-        if (vsBot && playerManager.getCurrentPlayer() == 'X') {
+        if (botTurn) {
           cout << "Bot's turn to play." << endl; // Debug statement
+        auto searchStart = chrono::steady_clock::now();
+        botManager.setTimeLimit(clock.moveBudgetMs('X')); // Never lose on time
         botManager.makeMove(); // Make the bot move
+        auto searchMicros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - searchStart).count();
+        bool inTime = clock.endTurn();
         int botRow = botManager.getLastRow();
         int botCol = botManager.getLastCol();
+        if (botRow != -1) recorder.addMove(botRow, botCol, (uint32_t)searchMicros, botManager.getLastNodes());
         
         if (botRow == -1 || botCol == -1) {
         cout << "Bot did not make a move. Check bot logic." << endl; // Debug statement
@@ -950,63 +628,106 @@ public:
         cout << "Bot placed at (" << botRow << ", " << botCol << ")." << endl; // Debug statement
     }
 
-        cleardevice(); // Clear screen and redraw
-        grid.drawGrid();
+        auto redrawStart = chrono::steady_clock::now();
+        screen.clear(); // Clear screen and redraw
+        gridView.drawGrid();
+        timings.redraw.recordSince(redrawStart);
+        shownTimer.clear();
 
         // Check for a winner or draw
+        auto checkStart = chrono::steady_clock::now();
         WinSequence winSeq = gameLogic.checkWinner(botRow, botCol);
-        if (winSeq.hasWinner) {
-            grid.drawWinningLine(winSeq.startRow, winSeq.startCol, winSeq.endRow, winSeq.endCol);
+        bool full = grid.isFull();
+        timings.winCheck.recordSince(checkStart);
+        if (!inTime) {
+            gameOver = true; // The bot ran out of time
+            recorder.endGame('O');
+            displayWinner(player1Name);
+        } else if (winSeq.hasWinner) {
+            gridView.drawWinningLine(winSeq.startRow, winSeq.startCol, winSeq.endRow, winSeq.endCol);
             gameOver = true;
+            recorder.endGame('X');
             displayWinner(player2Name);
-        } else if (grid.isFull()) {
+        } else if (full) {
             gameOver = true;
+            recorder.endGame('D');
             displayDrawMessage();
         } else {
             playerManager.switchPlayer(); // Switch to the player
-            countdown = timerMode;       // Reset the timer
-            startTime = time(nullptr);   // Reset the start time
+            clock.start(playerManager.getCurrentPlayer()); // Start the player's clock
         }
     } else if (ismouseclick(WM_LBUTTONDOWN)) { // Player's turn
+        clickTime = chrono::steady_clock::now();
         int x = mousex();
         int y = mousey();
         clearmouseclick(WM_LBUTTONDOWN);
 
-        int row = (y - 100) / CELL_SIZE;
-        int col = (x - 20) / CELL_SIZE;
-
-        if (row >= 0 && row < rows && col >= 0 && col < cols && grid.isCellEmpty(row, col)) {
+        int row, col;
+        if (gridView.cellAt(x, y, row, col) && grid.isCellEmpty(row, col)) {
             char player = playerManager.getCurrentPlayer();
-            grid.setCell(row, col, player);
-            cleardevice(); // Clear screen and redraw
-            grid.drawGrid();
+            grid.makeMove(row, col, player);
+            recorder.addMove(row, col);
+            bool inTime = clock.endTurn();
+            auto redrawStart = chrono::steady_clock::now();
+            screen.clear(); // Clear screen and redraw
+            gridView.drawGrid();
+            timings.redraw.recordSince(redrawStart);
+            shownTimer.clear();
+            framePending = true;
 
             // Check for a winner or draw
+            auto checkStart = chrono::steady_clock::now();
             WinSequence winSeq = gameLogic.checkWinner(row, col);
-            if (winSeq.hasWinner) {
-                grid.drawWinningLine(winSeq.startRow, winSeq.startCol, winSeq.endRow, winSeq.endCol);
+            bool full = grid.isFull();
+            timings.winCheck.recordSince(checkStart);
+            if (!inTime) {
+                gameOver = true; // The move came too late
+                recorder.endGame(player == 'O' ? 'X' : 'O');
+                displayWinner(player == 'O' ? player2Name : player1Name);
+            } else if (winSeq.hasWinner) {
+                gridView.drawWinningLine(winSeq.startRow, winSeq.startCol, winSeq.endRow, winSeq.endCol);
                 gameOver = true;
+                recorder.endGame(player);
                 displayWinner(player == 'O' ? player1Name : player2Name);
-            } else if (grid.isFull()) {
+            } else if (full) {
                 gameOver = true;
+                recorder.endGame('D');
                 displayDrawMessage();
             } else {
                 playerManager.switchPlayer(); // Switch to the bot (if vsBot)
-                countdown = timerMode;       // Reset the timer
-                startTime = time(nullptr);   // Reset the start time
+                clock.start(playerManager.getCurrentPlayer()); // Start the next player's clock
                     }
                 }
             }
-            delay(10);
+            if (!framePending) delay(10); // Show a move's frame right away
         }
-        if (gameOver) {
-    cout << "Game over! Press any key to exit." << endl;
-    getch(); // Wait for user input before exiting
-    closegraph(); // Close the graphics window explicitly
-}
+        recorder.close();
+        remove(SAVED_GAME_PATH); // Finished, nothing to resume
+        timings.print(cout);
+        return endGame();
+    }
+
+public:
+    void run() {
+        WindowManager::openWindow();
+        Scene scene = loadSavedGame() ? SCENE_NAMES : SCENE_BOARD_MENU;
+        while (scene != SCENE_EXIT) {
+            clearmouseclick(WM_LBUTTONDOWN); // A click belongs to the scene it was made in
+            switch (scene) {
+            case SCENE_BOARD_MENU: scene = boardMenu(); break;
+            case SCENE_TIMER_MENU: scene = timerMenu(); break;
+            case SCENE_MODE_MENU: scene = modeMenu(); break;
+            case SCENE_NAMES: scene = nameInput(); break;
+            case SCENE_GAME: scene = playGame(); break;
+            case SCENE_INFINITE: scene = playInfinite(); break;
+            default: scene = SCENE_EXIT;
+            }
+        }
+        closegraph(); // Close the graphics window explicitly
     }
 };
 
+
 int main() {
     Application app;
     app.run();
@@ -1,18 +1,20 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "solver.h"
 
 using namespace std;
 
 class TicTacToe {
 private:
     int rows, cols;
+    int winLength; // Stones in a row that win
     vector<vector<char>> grid;
     char currentPlayer;
     bool gameOver;
 
 public:
-    TicTacToe(int n, int m) : rows(n), cols(m), currentPlayer('O'), gameOver(false) {
+    TicTacToe(int n, int m, int k = 5) : rows(n), cols(m), winLength(k), currentPlayer('O'), gameOver(false) {
         grid.resize(rows, vector<char>(cols, ' '));
     }
 
@@ -38,33 +40,48 @@ public:
         int count = 0;
         for (int j = 0; j < cols; ++j) {
             count = (grid[row][j] == symbol) ? count + 1 : 0;
-            if (count == 5) return true;
+            if (count == winLength) return true;
         }
 
         // Check vertical
         count = 0;
         for (int i = 0; i < rows; ++i) {
             count = (grid[i][col] == symbol) ? count + 1 : 0;
-            if (count == 5) return true;
+            if (count == winLength) return true;
         }
 
         // Check diagonal (\)
         count = 0;
         for (int i = -min(row, col); i < min(rows - row, cols - col); ++i) {
             count = (grid[row + i][col + i] == symbol) ? count + 1 : 0;
-            if (count == 5) return true;
+            if (count == winLength) return true;
         }
 
         // Check diagonal (/)
         count = 0;
         for (int i = -min(row, cols - 1 - col); i < min(rows - row, col + 1); ++i) {
             count = (grid[row + i][col - i] == symbol) ? count + 1 : 0;
-            if (count == 5) return true;
+            if (count == winLength) return true;
         }
 
         return false;   
     }
 
+    // Play the perfect move for the player to move, on boards small enough
+    // to have a solved table (3x3 always); false otherwise
+    bool playSolvedMove() {
+        const SolvedTable *table = SolvedTable::find(rows, cols, winLength);
+        if (!table || gameOver) return false;
+        string cells;
+        for (const auto &row : grid) cells.append(row.begin(), row.end());
+        int index;
+        if (!table->bestMove(cells.c_str(), currentPlayer, index)) return false;
+        handleMove(index / cols, index % cols);
+        return true;
+    }
+
+    bool isGameOver() const { return gameOver; }
+
     void displayBoard() {
         for (int i = 0; i < rows; ++i) {
             for (int j = 0; j < cols; ++j) {
@@ -81,5 +98,10 @@ int main() {
     game.handleMove(0, 0); 
     game.displayBoard();
 
+    // Classic tic-tac-toe played perfectly by both sides ends in a draw
+    TicTacToe classic(3, 3, 3);
+    while (!classic.isGameOver() && classic.playSolvedMove()) {}
+    classic.displayBoard();
+
 return 0;   
 }
\ No newline at end of file
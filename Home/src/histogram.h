@@ -0,0 +1,91 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+// Fixed-size latency histogram for timing code that runs often, such as
+// every frame of the GUI. Recording is a few shifts and an increment with no
+// allocation. Values are microseconds in log-linear buckets: every power of
+// two is split into 16 equal buckets, so a percentile is exact below 32 us
+// and within about 6% above that, from 1 us to hours.
+
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <algorithm>
+
+class LatencyHistogram {
+private:
+    static const int SUB_BUCKETS = 16; // Buckets per power of two
+    static const int SUB_BITS = 4;
+    static const int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    uint64_t counts[BUCKETS];
+    uint64_t total, sum, minValue, maxValue;
+
+    // Values below 2 * SUB_BUCKETS get a bucket each; above, the top five bits pick it
+    static int bucketOf(uint64_t v) {
+        if (v < 2 * SUB_BUCKETS) return (int)v;
+        int exponent = SUB_BITS + 1; // Highest set bit
+        while (v >> (exponent + 1)) exponent++;
+        return (exponent - SUB_BITS + 1) * SUB_BUCKETS + (int)((v >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1));
+    }
+
+    // Largest value that falls in bucket b
+    static uint64_t bucketTop(int b) {
+        if (b < 2 * SUB_BUCKETS) return (uint64_t)b;
+        int exponent = b / SUB_BUCKETS + SUB_BITS - 1;
+        uint64_t low = ((uint64_t)(SUB_BUCKETS + b % SUB_BUCKETS)) << (exponent - SUB_BITS);
+        return low + ((uint64_t)1 << (exponent - SUB_BITS)) - 1;
+    }
+
+public:
+    LatencyHistogram() { clear(); }
+
+    void clear() {
+        for (uint64_t &c : counts) c = 0;
+        total = sum = maxValue = 0;
+        minValue = UINT64_MAX;
+    }
+
+    void record(uint64_t micros) {
+        counts[bucketOf(micros)]++;
+        total++;
+        sum += micros;
+        if (micros < minValue) minValue = micros;
+        if (micros > maxValue) maxValue = micros;
+    }
+
+    // Record the time since start
+    void recordSince(std::chrono::steady_clock::time_point start) {
+        record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    uint64_t getCount() const { return total; }
+
+    // Smallest bucket top at or above fraction p of the values (0.5 for the median)
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)(p * total);
+        if (rank >= total) rank = total - 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += counts[b];
+            if (seen > rank) return std::min(bucketTop(b), maxValue);
+        }
+        return maxValue;
+    }
+
+    // One line: count, mean, min, percentiles and max in milliseconds
+    void print(std::ostream &out, const std::string &name) const {
+        out << name << ": ";
+        if (total == 0) {
+            out << "no samples" << std::endl;
+            return;
+        }
+        auto ms = [](uint64_t micros) { return std::to_string(micros / 1000) + "." + std::to_string(micros % 1000 / 100); };
+        out << total << " samples, mean " << ms(sum / total) << " ms, min " << ms(minValue) << ", p50 " << ms(percentile(0.5))
+            << ", p90 " << ms(percentile(0.9)) << ", p99 " << ms(percentile(0.99)) << ", max " << ms(maxValue) << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,326 @@
+#ifndef INFINITE_H
+#define INFINITE_H
+
+// Unbounded ("freestyle, no edges") board.
+//
+// SparseBoard keeps the stones in 8x8 tiles, one 64-bit bitboard per side,
+// in a hash map keyed by tile coordinates, so memory and every operation
+// depend on the stones played, never on an area. Coordinates can be any
+// int, negative included; the first move is usually (0, 0).
+//
+// InfiniteBot reuses BotManager: it copies the stones' bounding box plus a
+// margin into a small dense Grid, searches that, and maps the move back, so
+// a search costs the same as on a bounded board of that size.
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include "engine.h"
+
+class SparseBoard {
+private:
+    struct Tile {
+        uint64_t bits[2]; // 'O' stones, 'X' stones; bit (row % 8) * 8 + col % 8
+        int stones;
+    };
+
+    std::unordered_map<uint64_t, Tile> tiles;
+    std::vector<Move> moves; // Every stone, oldest first; unmakeMove() pops
+    int winLength;
+
+    // Tile coordinate of a cell coordinate, rounding down for negatives
+    static int tileOf(int v) { return (v >= 0 ? v : v - 7) / 8; }
+    static int bitOf(int row, int col) { return (row - tileOf(row) * 8) * 8 + (col - tileOf(col) * 8); }
+
+    static uint64_t tileKey(int row, int col) {
+        return (uint64_t)(uint32_t)tileOf(row) << 32 | (uint32_t)tileOf(col);
+    }
+
+    // Stones of symbol in a row from (row, col) along (dr, dc), not counting the cell itself
+    int countDirection(int row, int col, int dr, int dc, char symbol) const {
+        int count = 0;
+        for (int i = 1; i < winLength && getCell(row + i * dr, col + i * dc) == symbol; ++i) count++;
+        return count;
+    }
+
+public:
+    SparseBoard(int k = DEFAULT_WIN_LENGTH) : winLength(k) {}
+
+    int getWinLength() const { return winLength; }
+
+    char getCell(int row, int col) const {
+        auto it = tiles.find(tileKey(row, col));
+        if (it == tiles.end()) return ' ';
+        uint64_t bit = 1ull << bitOf(row, col);
+        if (it->second.bits[0] & bit) return 'O';
+        if (it->second.bits[1] & bit) return 'X';
+        return ' ';
+    }
+
+    bool isCellEmpty(int row, int col) const { return getCell(row, col) == ' '; }
+
+    void makeMove(int row, int col, char symbol) {
+        Tile &tile = tiles[tileKey(row, col)]; // Value-initialised when new
+        tile.bits[symbol == 'X'] |= 1ull << bitOf(row, col);
+        tile.stones++;
+        moves.push_back({row, col});
+    }
+
+    void unmakeMove() {
+        Move last = moves.back();
+        moves.pop_back();
+        auto it = tiles.find(tileKey(last.row, last.col));
+        uint64_t bit = 1ull << bitOf(last.row, last.col);
+        it->second.bits[0] &= ~bit;
+        it->second.bits[1] &= ~bit;
+        if (--it->second.stones == 0) tiles.erase(it);
+    }
+
+    void clear() {
+        tiles.clear();
+        moves.clear();
+    }
+
+    int getMoveCount() const { return (int)moves.size(); }
+    int getMoveRow(int i) const { return moves[i].row; }
+    int getMoveCol(int i) const { return moves[i].col; }
+    size_t getTileCount() const { return tiles.size(); }
+
+    // Smallest rectangle holding every stone; false on an empty board
+    bool getBounds(int &minRow, int &minCol, int &maxRow, int &maxCol) const {
+        if (moves.empty()) return false;
+        minRow = maxRow = moves[0].row;
+        minCol = maxCol = moves[0].col;
+        for (const Move &m : moves) {
+            minRow = std::min(minRow, m.row);
+            maxRow = std::max(maxRow, m.row);
+            minCol = std::min(minCol, m.col);
+            maxCol = std::max(maxCol, m.col);
+        }
+        return true;
+    }
+
+    // Empty cells that give symbol k in a row (fives) and cells that leave it
+    // one stone short of k in a line of k with no other stone (fours), read
+    // off the k-cell lines through its stones. Cells can repeat.
+    void findThreats(char symbol, std::vector<Move> &fives, std::vector<Move> &fours) const {
+        fives.clear();
+        fours.clear();
+        for (const Move &m : moves) {
+            if (getCell(m.row, m.col) != symbol) continue;
+            for (const auto &dir : LINE_DIRECTIONS) {
+                for (int start = 1 - winLength; start <= 0; ++start) {
+                    int own = 0, empty = 0;
+                    Move gaps[2] = {};
+                    for (int i = 0; i < winLength; ++i) {
+                        int row = m.row + (start + i) * dir[0], col = m.col + (start + i) * dir[1];
+                        char cell = getCell(row, col);
+                        if (cell == symbol) {
+                            own++;
+                        } else if (cell != ' ' || empty == 2) {
+                            empty = 3; // Blocked, or too many gaps to matter
+                            break;
+                        } else {
+                            gaps[empty++] = {row, col};
+                        }
+                    }
+                    if (empty == 1 && own == winLength - 1) fives.push_back(gaps[0]);
+                    if (empty == 2 && own == winLength - 2) {
+                        fours.push_back(gaps[0]);
+                        fours.push_back(gaps[1]);
+                    }
+                }
+            }
+        }
+    }
+
+    // K or more in a row through the stone on (row, col)
+    WinSequence checkWinner(int row, int col) const {
+        char symbol = getCell(row, col);
+        if (symbol == ' ') return {false, -1, -1, -1, -1};
+        for (const auto &dir : LINE_DIRECTIONS) {
+            int after = countDirection(row, col, dir[0], dir[1], symbol);
+            int before = countDirection(row, col, -dir[0], -dir[1], symbol);
+            if (before + after + 1 >= winLength) {
+                return {true, row - before * dir[0], col - before * dir[1], row + after * dir[0], col + after * dir[1]};
+            }
+        }
+        return {false, -1, -1, -1, -1};
+    }
+};
+
+// Bot for a SparseBoard, searching a dense window around the stones. The
+// window and the BotManager searching it are kept from move to move while
+// the stones stay inside, so the transposition table entries, keyed on
+// window cells and size, stay valid; moves taken back on the board are taken
+// back on the window, and the window is rebuilt with room to grow when the
+// game outgrows it.
+class InfiniteBot {
+private:
+    SparseBoard &board;
+    char botSymbol;
+    EvalWeights weights;
+    int searchDepth;
+    long long timeLimitMs; // Passed on to BotManager::setTimeLimit
+    int level;             // Passed on to BotManager::setLevel, -1 for none
+    uint64_t levelSeed;
+    TranspositionTable table;
+    std::unique_ptr<Grid> window;
+    std::unique_ptr<BotManager> bot; // Searches window
+    int windowTop, windowLeft;       // Board cell of the window's (0, 0)
+    std::vector<Move> synced;        // Board moves the window has seen, in order
+    std::vector<char> placed;        // Whether each of them is inside the window
+    std::vector<Move> opponentFives, opponentFours, ownFives, ownFours; // findThreats() results, kept for their memory
+    int lastRow, lastCol;
+    long long nodeCount;
+
+    // Longest window side. A larger game is cut to a window around the cells
+    // that matter most (see focusOn()); stones outside it are not seen.
+    static const int MAX_WINDOW = 96;
+
+    // Cells the window must hold, with room for the lines through them
+    struct Focus {
+        int top, bottom, left, right;
+        bool empty;
+    };
+
+    // Add a cell to focus unless the focus would grow past what a window holds with margin around it
+    static void focusOn(Focus &focus, const Move &cell, int margin) {
+        int top = focus.empty ? cell.row : std::min(focus.top, cell.row);
+        int bottom = focus.empty ? cell.row : std::max(focus.bottom, cell.row);
+        int left = focus.empty ? cell.col : std::min(focus.left, cell.col);
+        int right = focus.empty ? cell.col : std::max(focus.right, cell.col);
+        if (bottom - top + 1 > MAX_WINDOW - 2 * margin || right - left + 1 > MAX_WINDOW - 2 * margin) return;
+        focus = {top, bottom, left, right, false};
+    }
+
+    // Clamp [low, high] to at most MAX_WINDOW cells centered on [focusLow, focusHigh]
+    static void clampSpan(int &low, int &high, int focusLow, int focusHigh) {
+        if (high - low + 1 <= MAX_WINDOW) return;
+        low = std::max(low, (focusLow + focusHigh) / 2 - MAX_WINDOW / 2);
+        high = low + MAX_WINDOW - 1;
+    }
+
+    // Extra cells on each side of [low, high] for a new window, up to MAX_WINDOW in all
+    int slack(int low, int high) const {
+        return std::max(0, std::min(board.getWinLength(), (MAX_WINDOW - (high - low + 1)) / 2));
+    }
+
+    bool windowCovers(int top, int bottom, int left, int right) {
+        return window && top >= windowTop && left >= windowLeft && bottom < windowTop + window->getRows() &&
+               right < windowLeft + window->getCols();
+    }
+
+    void buildWindow(int top, int bottom, int left, int right) {
+        bot.reset(); // Holds a reference to the old window
+        window.reset(new Grid(bottom - top + 1, right - left + 1, board.getWinLength()));
+        bot.reset(new BotManager(*window, botSymbol, weights, &table));
+        windowTop = top;
+        windowLeft = left;
+        synced.clear();
+        placed.clear();
+    }
+
+    // Bring the window to the board's moves: take back the moves the board no
+    // longer has, then copy the new ones in order, so the bot sees the same
+    // move history. Stones outside the window are left out.
+    void syncWindow() {
+        size_t same = 0;
+        while (same < synced.size() && (int)same < board.getMoveCount() && board.getMoveRow((int)same) == synced[same].row &&
+               board.getMoveCol((int)same) == synced[same].col) {
+            same++;
+        }
+        while (synced.size() > same) {
+            if (placed.back()) window->unmakeMove();
+            synced.pop_back();
+            placed.pop_back();
+        }
+        for (int i = (int)same; i < board.getMoveCount(); ++i) {
+            int row = board.getMoveRow(i), col = board.getMoveCol(i);
+            int r = row - windowTop, c = col - windowLeft;
+            bool inside = r >= 0 && r < window->getRows() && c >= 0 && c < window->getCols();
+            if (inside) window->makeMove(r, c, board.getCell(row, col));
+            synced.push_back({row, col});
+            placed.push_back(inside);
+        }
+    }
+
+public:
+    InfiniteBot(SparseBoard &b, char symbol, const EvalWeights &w = EvalWeights::defaults())
+        : board(b), botSymbol(symbol), weights(w), searchDepth(2), timeLimitMs(0), level(-1), levelSeed(0), windowTop(0),
+          windowLeft(0), lastRow(0), lastCol(0), nodeCount(0) {}
+
+    void setSearchDepth(int depth) { searchDepth = depth; }
+    void setTimeLimit(long long ms) { timeLimitMs = ms; }
+
+    // Play at one of BOT_LEVELS; replaces the search depth
+    void setLevel(int botLevel, uint64_t seed) {
+        level = botLevel;
+        levelSeed = seed;
+    }
+
+    // Play the bot's move; false if it found none, when getLastRow() and
+    // getLastCol() are not a move (every int is a cell on this board)
+    bool makeMove() {
+        nodeCount = 0;
+        int minRow, minCol, maxRow, maxCol;
+        if (!board.getBounds(minRow, minCol, maxRow, maxCol)) {
+            lastRow = lastCol = 0; // Open in the middle of nowhere
+            board.makeMove(0, 0, botSymbol);
+            return true;
+        }
+
+        // Empty cells kept around the stones, past any line scan of the search
+        int margin = board.getWinLength() + 1;
+        int moves = board.getMoveCount();
+        int top = minRow - margin, bottom = maxRow + margin;
+        int left = minCol - margin, right = maxCol + margin;
+        if (bottom - top + 1 > MAX_WINDOW || right - left + 1 > MAX_WINDOW) {
+            // Too large for one window: keep the cells where the game can be
+            // won or lost next inside it, most urgent first. The opponent's
+            // fives must be blocked, then come the bot's fives and the
+            // opponent's fours; the last move fills in around them. Threats
+            // too far apart for one window are dropped in the same order, so
+            // the bot can miss a far four when it already faces a five.
+            Focus focus = {0, 0, 0, 0, true};
+            char opponent = botSymbol == 'O' ? 'X' : 'O';
+            board.findThreats(opponent, opponentFives, opponentFours);
+            board.findThreats(botSymbol, ownFives, ownFours);
+            for (const Move &cell : opponentFives) focusOn(focus, cell, margin);
+            for (const Move &cell : ownFives) focusOn(focus, cell, margin);
+            for (const Move &cell : opponentFours) focusOn(focus, cell, margin);
+            focusOn(focus, {board.getMoveRow(moves - 1), board.getMoveCol(moves - 1)}, margin);
+            clampSpan(top, bottom, focus.top, focus.bottom);
+            clampSpan(left, right, focus.left, focus.right);
+        }
+
+        if (!windowCovers(top, bottom, left, right)) {
+            int rowSlack = slack(top, bottom), colSlack = slack(left, right);
+            buildWindow(top - rowSlack, bottom + rowSlack, left - colSlack, right + colSlack);
+        }
+        syncWindow();
+
+        bot->setSearchDepth(searchDepth);
+        if (level >= 0) bot->setLevel(level, levelSeed);
+        bot->setTimeLimit(timeLimitMs);
+        bot->setVerbose(false);
+        bot->makeMove();
+        nodeCount = bot->getLastNodes();
+        if (bot->getLastRow() == -1) return false; // The window is full; cannot happen with the margin
+
+        lastRow = bot->getLastRow() + windowTop;
+        lastCol = bot->getLastCol() + windowLeft;
+        board.makeMove(lastRow, lastCol, botSymbol); // Already on the window
+        synced.push_back({lastRow, lastCol});
+        placed.push_back(true);
+        return true;
+    }
+
+    int getLastRow() const { return lastRow; }
+    int getLastCol() const { return lastCol; }
+    long long getLastNodes() const { return nodeCount; }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Loopback test client for server.cpp: plays many games at once with random
+// human moves, checks every reply against its own copy of the boards and
+// reports bot latency.
+// Usage: loadclient [--port N | --unix PATH] [--games N] [--rows N] [--cols N] [--seed N]
+
+struct ClientGame {
+    vector<char> cells;
+    bool over;
+    chrono::steady_clock::time_point sentAt;
+};
+
+int connectToServer(int port, const string &unixPath) {
+    int fd;
+    if (unixPath.empty()) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        if (connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0) return -1;
+    } else {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0) return -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int port = 7070, gameCount = 100, rows = 10, cols = 10;
+    unsigned seed = 1;
+    string unixPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i], value = argv[i + 1];
+        if (arg == "--port") port = stoi(value);
+        else if (arg == "--unix") unixPath = value;
+        else if (arg == "--games") gameCount = stoi(value);
+        else if (arg == "--rows") rows = stoi(value);
+        else if (arg == "--cols") cols = stoi(value);
+        else if (arg == "--seed") seed = stoul(value);
+    }
+
+    int fd = connectToServer(port, unixPath);
+    if (fd < 0) {
+        cout << "Could not connect to the server" << endl;
+        return 1;
+    }
+
+    mt19937 rng(seed);
+    unordered_map<int, ClientGame> games;
+    vector<double> latencies;
+    int finished = 0, errors = 0, results[3] = {0, 0, 0};
+
+    // Pick a random empty cell, play it and remember when the move was sent
+    auto playRandom = [&](int id, ClientGame &game) {
+        vector<int> empty;
+        for (int i = 0; i < rows * cols; ++i) {
+            if (game.cells[i] == '.') empty.push_back(i);
+        }
+        int cell = empty[rng() % empty.size()];
+        game.cells[cell] = 'O';
+        game.sentAt = chrono::steady_clock::now();
+        return "MOVE " + to_string(id) + " " + to_string(cell / cols) + " " + to_string(cell % cols) + "\n";
+    };
+
+    string batch;
+    for (int g = 0; g < gameCount; ++g) batch += "NEW " + to_string(rows) + " " + to_string(cols) + " X\n";
+    auto start = chrono::steady_clock::now();
+    if (!sendAll(fd, batch)) return 1;
+
+    string in;
+    char buffer[65536];
+    while (finished < gameCount) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            cout << "Server closed the connection" << endl;
+            return 1;
+        }
+        in.append(buffer, n);
+
+        string out;
+        size_t begin = 0, newline;
+        while ((newline = in.find('\n', begin)) != string::npos) {
+            string line = in.substr(begin, newline - begin);
+            begin = newline + 1;
+
+            char kind[16] = "";
+            int id = 0, row = 0, col = 0;
+            char result = ' ';
+            sscanf(line.c_str(), "%15s %d", kind, &id);
+            string type = kind;
+
+            if (type == "GAME") {
+                ClientGame &game = games[id];
+                game.cells.assign(rows * cols, '.');
+                game.over = false;
+                out += playRandom(id, game);
+            } else if (type == "BOT") {
+                sscanf(line.c_str(), "%*s %d %d %d", &id, &row, &col);
+                ClientGame &game = games[id];
+                latencies.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - game.sentAt).count());
+                if (game.cells[row * cols + col] != '.') {
+                    cout << "Game " << id << ": bot played on an occupied cell" << endl;
+                    errors++;
+                }
+                game.cells[row * cols + col] = 'X';
+            } else if (type == "OVER") {
+                sscanf(line.c_str(), "%*s %d %c", &id, &result);
+                games[id].over = true;
+                finished++;
+                results[result == 'O' ? 0 : result == 'X' ? 1 : 2]++;
+                out += "END " + to_string(id) + "\n";
+            } else if (type == "ERR" && line.find("game is over") == string::npos) {
+                // "game is over" only means OVER arrived after we answered the bot
+                cout << line << endl;
+                errors++;
+            }
+        }
+        in.erase(0, begin);
+
+        // Answer every bot move that did not end its game
+        for (auto &entry : games) {
+            ClientGame &game = entry.second;
+            if (game.over) continue;
+            int placed = count(game.cells.begin(), game.cells.end(), 'O') - count(game.cells.begin(), game.cells.end(), 'X');
+            if (placed == 0) out += playRandom(entry.first, game);
+        }
+        if (!out.empty() && !sendAll(fd, out)) return 1;
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    sort(latencies.begin(), latencies.end());
+    cout << "Finished " << finished << " games in " << seconds << " s (human " << results[0] << ", bot "
+         << results[1] << ", draws " << results[2] << "), errors " << errors << endl;
+    if (!latencies.empty()) {
+        cout << "Bot reply latency ms: p50 " << latencies[latencies.size() / 2] << ", p99 "
+             << latencies[latencies.size() * 99 / 100] << ", max " << latencies.back() << endl;
+    }
+
+    sendAll(fd, "STATS\n");
+    size_t stats;
+    while ((stats = in.find("STATS")) == string::npos || in.find('\n', stats) == string::npos) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        in.append(buffer, n);
+    }
+    if (stats != string::npos) cout << in.substr(stats, in.find('\n', stats) - stats) << endl;
+    close(fd);
+    return errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cctype>
+#include <algorithm>
+#include "engine.h"
+#include "timecontrol.h"
+
+using namespace std;
+
+// The bot as a Gomoku engine for the Piskvork protocol (the one of Gomocup
+// and its tournament managers): commands on stdin, answers on stdout, one
+// per line. Build it as pbrain-tictactoe, the name managers look for.
+//
+// Supported: START, RECTSTART, RESTART, BEGIN, TURN, BOARD ... DONE, PLAY,
+// TAKEBACK, INFO, ABOUT, END. Coordinates are "x,y" with x the column.
+// Moves are timed from INFO timeout_turn, timeout_match and time_left (no
+// more than a share of the time left in the match), and the transposition
+// table takes half of INFO max_memory. Wins are five or more in a row
+// (freestyle); other rules are answered with a DEBUG line and played as
+// freestyle.
+
+const int MAX_BOARD_SIZE = 100;  // Largest board of the protocol
+const int SEARCH_DEPTH = 20;     // The time limit stops the search long before
+const long long DEFAULT_TABLE_BYTES = 16 << 20; // Without a memory limit
+
+class Brain {
+private:
+    unique_ptr<Grid> grid;
+    unique_ptr<BotManager> bot;
+    unique_ptr<TranspositionTable> table; // Kept across games
+    size_t tableEntries = 0;
+    char ownSymbol = 'X';
+
+    // INFO values; 0 means no limit (protocol defaults)
+    long long timeoutTurn = 30000;
+    long long timeoutMatch = 0;
+    long long timeLeft = 0;
+    long long maxMemory = 0;
+
+    static string upper(string s) {
+        for (char &c : s) c = (char)toupper((unsigned char)c);
+        return s;
+    }
+
+    static char other(char symbol) { return symbol == 'O' ? 'X' : 'O'; }
+
+    // "x,y" to a cell of the grid; false if it is not one
+    bool parseCell(const string &text, int &row, int &col) const {
+        size_t comma = text.find(',');
+        if (!grid || comma == string::npos) return false;
+        try {
+            col = stoi(text.substr(0, comma));
+            row = stoi(text.substr(comma + 1));
+        } catch (...) {
+            return false;
+        }
+        return row >= 0 && row < grid->getRows() && col >= 0 && col < grid->getCols();
+    }
+
+    void newGame(int rows, int cols) {
+        grid.reset(new Grid(rows, cols));
+        bot.reset();
+    }
+
+    // Milliseconds for this move: the turn limit, but no more than a share
+    // of the time left in the match, less a margin for the answer to arrive
+    long long moveBudgetMs() const {
+        long long budget = timeoutTurn > 0 ? timeoutTurn : 1; // 0: as fast as possible
+        if (timeoutMatch > 0 && timeLeft > 0) budget = min(budget, timeLeft / GameClock::MOVES_TO_GO);
+        return max(1LL, budget - GameClock::SAFETY_MS);
+    }
+
+    // The bot for the side that moves now. Whoever moved first plays 'O':
+    // with as many own stones as the opponent's, the brain started.
+    BotManager &botToMove() {
+        int own = 0, total = grid->getMoveCount();
+        for (int i = 0; i < total; ++i) {
+            if (grid->getCell(grid->getMoveRow(i), grid->getMoveCol(i)) == ownSymbol) own++;
+        }
+        char symbol = (own * 2 == total) ? 'O' : 'X';
+        if (symbol != ownSymbol) {
+            rebuild(-1, -1, true);
+            ownSymbol = symbol;
+        }
+
+        size_t entries = TranspositionTable::entriesForBytes(maxMemory > 0 ? maxMemory / 2 : DEFAULT_TABLE_BYTES);
+        if (!table || entries != tableEntries) {
+            bot.reset();
+            table.reset(new TranspositionTable(max<size_t>(entries, 1024)));
+            tableEntries = entries;
+        }
+        if (!bot) {
+            bot.reset(new BotManager(*grid, ownSymbol, EvalWeights::defaults(), table.get()));
+            bot->setSearchDepth(SEARCH_DEPTH);
+            bot->setVerbose(false);
+        }
+        return *bot;
+    }
+
+    // Play the stones again in their order on a new grid, leaving out the
+    // one at (skipRow, skipCol) and swapping O and X if asked
+    void rebuild(int skipRow, int skipCol, bool swapSymbols) {
+        vector<int> rows, cols;
+        vector<char> symbols;
+        for (int i = 0; i < grid->getMoveCount(); ++i) {
+            int row = grid->getMoveRow(i), col = grid->getMoveCol(i);
+            if (row == skipRow && col == skipCol) continue;
+            rows.push_back(row);
+            cols.push_back(col);
+            symbols.push_back(swapSymbols ? other(grid->getCell(row, col)) : grid->getCell(row, col));
+        }
+        newGame(grid->getRows(), grid->getCols());
+        for (size_t i = 0; i < symbols.size(); ++i) grid->makeMove(rows[i], cols[i], symbols[i]);
+    }
+
+    void playOwnMove() {
+        BotManager &b = botToMove();
+        b.setTimeLimit(moveBudgetMs());
+        b.makeMove();
+        if (b.getLastRow() == -1) {
+            cout << "ERROR no move left" << endl;
+            return;
+        }
+        cout << b.getLastCol() << "," << b.getLastRow() << endl;
+    }
+
+    bool placeStone(const string &text, char symbol) {
+        int row, col;
+        if (!parseCell(text, row, col) || !grid->isCellEmpty(row, col)) {
+            cout << "ERROR invalid move " << text << endl;
+            return false;
+        }
+        grid->makeMove(row, col, symbol);
+        return true;
+    }
+
+    void info(const string &key, const string &value) {
+        try {
+            if (key == "timeout_turn") timeoutTurn = stoll(value);
+            else if (key == "timeout_match") timeoutMatch = stoll(value);
+            else if (key == "time_left") timeLeft = stoll(value);
+            else if (key == "max_memory") maxMemory = stoll(value);
+            else if (key == "rule" && (stoi(value) & ~2) != 0) cout << "DEBUG rule " << value << " is played as freestyle" << endl;
+        } catch (...) {
+            cout << "DEBUG bad INFO value " << value << endl;
+        }
+    }
+
+    // Stones after BOARD, up to DONE: "x,y,1" own, "x,y,2" the opponent's
+    void readBoard(istream &in) {
+        newGame(grid->getRows(), grid->getCols());
+        string line;
+        while (getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (upper(line) == "DONE") break;
+            size_t comma = line.rfind(',');
+            if (comma == string::npos) continue;
+            string field = line.substr(comma + 1);
+            int row, col;
+            if (!parseCell(line.substr(0, comma), row, col) || !grid->isCellEmpty(row, col)) continue;
+            grid->makeMove(row, col, field == "1" ? ownSymbol : other(ownSymbol));
+        }
+        bot.reset(); // The bot keeps an index of the grid's moves
+    }
+
+public:
+    // Handle commands until END or the end of the input
+    void run(istream &in) {
+        string line;
+        while (getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t space = line.find(' ');
+            string command = upper(line.substr(0, space));
+            string args = space == string::npos ? "" : line.substr(space + 1);
+            if (command.empty()) continue;
+
+            if (command == "START" || command == "RECTSTART") {
+                int rows = 0, cols = 0;
+                try {
+                    size_t comma = args.find(',');
+                    cols = stoi(args.substr(0, comma));
+                    rows = (command == "START" || comma == string::npos) ? cols : stoi(args.substr(comma + 1));
+                } catch (...) {
+                }
+                if (rows < DEFAULT_WIN_LENGTH || cols < DEFAULT_WIN_LENGTH || rows > MAX_BOARD_SIZE || cols > MAX_BOARD_SIZE) {
+                    cout << "ERROR unsupported size " << args << endl;
+                    continue;
+                }
+                newGame(rows, cols);
+                cout << "OK" << endl;
+            } else if (command == "ABOUT") {
+                cout << "name=\"Tic-tac-toe\", version=\"1.0\"" << endl;
+            } else if (command == "END") {
+                break;
+            } else if (command == "INFO") {
+                size_t split = args.find(' ');
+                info(args.substr(0, split), split == string::npos ? "" : args.substr(split + 1));
+            } else if (!grid) {
+                cout << "ERROR no game, send START first" << endl;
+            } else if (command == "RESTART") {
+                newGame(grid->getRows(), grid->getCols());
+                cout << "OK" << endl;
+            } else if (command == "BEGIN") {
+                playOwnMove();
+            } else if (command == "TURN") {
+                if (placeStone(args, other(ownSymbol))) playOwnMove();
+            } else if (command == "BOARD") {
+                readBoard(in);
+                playOwnMove();
+            } else if (command == "PLAY") {
+                botToMove(); // Settles which side the brain plays
+                if (placeStone(args, ownSymbol)) cout << args << endl;
+            } else if (command == "TAKEBACK") {
+                int row, col;
+                if (!parseCell(args, row, col) || grid->isCellEmpty(row, col)) {
+                    cout << "ERROR invalid move " << args << endl;
+                    continue;
+                }
+                rebuild(row, col, false);
+                cout << "OK" << endl;
+            } else {
+                cout << "UNKNOWN " << command << endl;
+            }
+        }
+    }
+};
+
+int main() {
+    ios::sync_with_stdio(false);
+    Brain brain;
+    brain.run(cin);
+    return 0;
+}
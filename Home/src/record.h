@@ -0,0 +1,280 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+// Compact binary game records.
+//
+// A record file is a plain concatenation of games. Each game is:
+//   magic "TTR" + version byte
+//   rows (u8), cols (u8), time control, player types (u8), flags (u8)
+//   time control: mode (u8, a TimeMode), then main, increment and period
+//                 milliseconds and the period count (varints)
+//   win length (u8), only when FLAG_WIN_LENGTH is set; 5 otherwise
+//   moves: varint(row * cols + col + 1), each followed by
+//          varint(search microseconds) varint(nodes) when FLAG_STATS is set
+//   varint 0 to end the move list, then the result byte ('O', 'X' or 'D')
+// Varints are unsigned LEB128, so a move on a board up to 11x11 takes one byte.
+// Version 1 records stored only seconds per turn (varint) for the time
+// control; they are still read, as a per-move time control.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "engine.h"
+#include "timecontrol.h"
+
+const unsigned char RECORD_VERSION = 2;
+
+// Player type bits in GameHeader::playerTypes
+const unsigned char PLAYER_O_BOT = 1;
+const unsigned char PLAYER_X_BOT = 2;
+
+// GameHeader::flags
+const unsigned char FLAG_STATS = 1;
+const unsigned char FLAG_WIN_LENGTH = 2; // Set by the writer when the win length is not 5
+
+const int RECORD_DEFAULT_WIN_LENGTH = 5;
+
+struct GameHeader {
+    int rows, cols;
+    TimeControl timeControl;
+    unsigned char playerTypes;  // PLAYER_*_BOT bits
+    unsigned char flags;        // FLAG_* bits
+    int winLength;              // Stones in a row that win; 0 means 5
+};
+
+struct MoveRecord {
+    int row, col;
+    uint32_t searchMicros;      // 0 for human moves or when FLAG_STATS is clear
+    uint64_t nodes;
+};
+
+struct GameRecord {
+    GameHeader header;
+    std::vector<MoveRecord> moves;
+    char result;                // 'O', 'X' or 'D' for a draw
+};
+
+// Buffered writer; games are appended to the end of the file
+class GameRecordWriter {
+private:
+    FILE *file;
+    std::vector<unsigned char> buffer;
+    GameHeader header;
+    static const size_t FLUSH_SIZE = 1 << 16;
+
+    void putByte(unsigned char b) {
+        buffer.push_back(b);
+    }
+
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((unsigned char)value);
+    }
+
+public:
+    GameRecordWriter() : file(nullptr), header() {
+        buffer.reserve(FLUSH_SIZE + 64);
+    }
+
+    ~GameRecordWriter() {
+        close();
+    }
+
+    bool open(const std::string &path) {
+        close();
+        file = fopen(path.c_str(), "ab");
+        return file != nullptr;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void beginGame(const GameHeader &h) {
+        header = h;
+        putByte('T');
+        putByte('T');
+        putByte('R');
+        putByte(RECORD_VERSION);
+        putByte((unsigned char)h.rows);
+        putByte((unsigned char)h.cols);
+        putByte((unsigned char)h.timeControl.mode);
+        putVarint(h.timeControl.mainMs);
+        putVarint(h.timeControl.incrementMs);
+        putVarint(h.timeControl.periodMs);
+        putVarint(h.timeControl.periods);
+        putByte(h.playerTypes);
+        bool customLength = (h.winLength != 0 && h.winLength != RECORD_DEFAULT_WIN_LENGTH);
+        putByte((unsigned char)(customLength ? (h.flags | FLAG_WIN_LENGTH) : (h.flags & ~FLAG_WIN_LENGTH)));
+        if (customLength) putByte((unsigned char)h.winLength);
+    }
+
+    void addMove(int row, int col, uint32_t searchMicros = 0, uint64_t nodes = 0) {
+        putVarint((uint64_t)(row * header.cols + col) + 1);
+        if (header.flags & FLAG_STATS) {
+            putVarint(searchMicros);
+            putVarint(nodes);
+        }
+    }
+
+    void endGame(char result) {
+        putVarint(0);
+        putByte((unsigned char)result);
+        if (buffer.size() >= FLUSH_SIZE) flush();
+    }
+
+    void writeGame(const GameRecord &game) {
+        beginGame(game.header);
+        for (const MoveRecord &m : game.moves) addMove(m.row, m.col, m.searchMicros, m.nodes);
+        endGame(game.result);
+    }
+
+    void flush() {
+        if (file && !buffer.empty()) {
+            fwrite(buffer.data(), 1, buffer.size(), file);
+            fflush(file);
+        }
+        buffer.clear();
+    }
+
+    void close() {
+        flush();
+        if (file) fclose(file);
+        file = nullptr;
+    }
+};
+
+// Streaming reader: nextGame() reads a header, then nextMove() until it returns false
+class GameRecordReader {
+private:
+    FILE *file;
+    std::vector<unsigned char> buffer;
+    size_t pos, end;
+    bool eof;
+    GameHeader header;
+    char result;
+    static const size_t BUFFER_SIZE = 1 << 20;
+    static const size_t MAX_ITEM_SIZE = 64; // Largest header or move with stats
+
+    // Make sure at least MAX_ITEM_SIZE bytes are buffered unless the file ends first
+    void fill() {
+        if (eof || end - pos >= MAX_ITEM_SIZE) return;
+        memmove(buffer.data(), buffer.data() + pos, end - pos);
+        end -= pos;
+        pos = 0;
+        size_t got = fread(buffer.data() + end, 1, BUFFER_SIZE - end, file);
+        end += got;
+        if (got == 0) eof = true;
+    }
+
+    bool getByte(unsigned char &b) {
+        if (pos >= end) return false;
+        b = buffer[pos++];
+        return true;
+    }
+
+    bool getVarint(uint64_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            unsigned char b;
+            if (!getByte(b)) return false;
+            value |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+public:
+    GameRecordReader() : file(nullptr), buffer(BUFFER_SIZE), pos(0), end(0), eof(false), header(), result(' ') {}
+
+    ~GameRecordReader() {
+        if (file) fclose(file);
+    }
+
+    bool open(const std::string &path) {
+        if (file) fclose(file);
+        file = fopen(path.c_str(), "rb");
+        pos = end = 0;
+        eof = false;
+        return file != nullptr;
+    }
+
+    // Read the next game header; false at end of file or on a corrupt record
+    bool nextGame(GameHeader &h) {
+        fill();
+        unsigned char magic[4];
+        for (auto &b : magic) {
+            if (!getByte(b)) return false;
+        }
+        if (magic[0] != 'T' || magic[1] != 'T' || magic[2] != 'R' || magic[3] < 1 || magic[3] > RECORD_VERSION) return false;
+
+        unsigned char rows, cols;
+        if (!getByte(rows) || !getByte(cols) || rows == 0 || cols == 0) return false;
+        if (magic[3] == 1) {
+            uint64_t seconds;
+            if (!getVarint(seconds)) return false;
+            header.timeControl = TimeControl::perMove((long long)seconds * 1000);
+        } else {
+            unsigned char mode;
+            uint64_t mainMs, incrementMs, periodMs, periods;
+            if (!getByte(mode) || mode > TIME_BYOYOMI || !getVarint(mainMs) || !getVarint(incrementMs) ||
+                !getVarint(periodMs) || !getVarint(periods)) return false;
+            header.timeControl = {(TimeMode)mode, (long long)mainMs, (long long)incrementMs, (long long)periodMs, (int)periods};
+        }
+        if (!getByte(header.playerTypes) || !getByte(header.flags)) return false;
+        header.rows = rows;
+        header.cols = cols;
+        header.winLength = RECORD_DEFAULT_WIN_LENGTH;
+        if (header.flags & FLAG_WIN_LENGTH) {
+            unsigned char winLength;
+            if (!getByte(winLength)) return false;
+            header.winLength = winLength;
+        }
+        // A k the engine's line tables cannot hold, or that fits on no line of the board
+        if (header.winLength < MIN_WIN_LENGTH || header.winLength > MAX_WIN_LENGTH ||
+            header.winLength > std::min(header.rows, header.cols)) return false;
+        result = ' ';
+        h = header;
+        return true;
+    }
+
+    // Read the next move of the current game; false once the game is over
+    bool nextMove(MoveRecord &m) {
+        fill();
+        uint64_t cell;
+        if (!getVarint(cell)) return false;
+        if (cell == 0) {
+            unsigned char r;
+            result = getByte(r) ? (char)r : ' ';
+            return false;
+        }
+        if (--cell >= (uint64_t)header.rows * header.cols) return false; // Off the board
+        m.row = (int)(cell / header.cols);
+        m.col = (int)(cell % header.cols);
+        m.searchMicros = 0;
+        m.nodes = 0;
+        if (header.flags & FLAG_STATS) {
+            uint64_t micros;
+            if (!getVarint(micros) || !getVarint(m.nodes)) return false;
+            m.searchMicros = (uint32_t)micros;
+        }
+        return true;
+    }
+
+    // Result of the game whose moves were just read
+    char getResult() const { return result; }
+
+    bool readGame(GameRecord &game) {
+        if (!nextGame(game.header)) return false;
+        game.moves.clear();
+        MoveRecord m;
+        while (nextMove(m)) game.moves.push_back(m);
+        game.result = result;
+        return result != ' ';
+    }
+};
+
+#endif
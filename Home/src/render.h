@@ -0,0 +1,418 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+// Drawing for the game's screens, without graphics.h.
+//
+// Renderer is what the views draw through: lines, rectangles, filled bars
+// and text, each call taking its own colour, so there is no drawing state to
+// set up first. SoftwareRenderer draws into a framebuffer in memory: bars and
+// clears fill rows four pixels at a time with SSE2 where the compiler has it,
+// and text is stamped from a glyph atlas (the built-in 8x8 font scaled to
+// each text size, built on first use and kept). Finished frames go to a
+// FrameSink, which is the window in the GUI, or to a PNG file.
+//
+// Pixels are 32-bit 0xAARRGGBB words, which is B, G, R, A in memory on
+// little-endian machines, the layout Windows device-independent bitmaps use.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RENDER_SSE2 1
+#endif
+
+constexpr uint32_t makePixel(int r, int g, int b) {
+    return 0xFF000000u | (uint32_t)r << 16 | (uint32_t)g << 8 | (uint32_t)b;
+}
+
+// The graphics.h colours the game uses
+const uint32_t PIXEL_BLACK = makePixel(0, 0, 0);
+const uint32_t PIXEL_WHITE = makePixel(255, 255, 255);
+const uint32_t PIXEL_RED = makePixel(168, 0, 0);
+const uint32_t PIXEL_LIGHTCYAN = makePixel(84, 252, 252);
+const uint32_t PIXEL_YELLOW = makePixel(252, 252, 84);
+const uint32_t PIXEL_DARKGRAY = makePixel(84, 84, 84);
+
+const int MAX_TEXT_SIZE = 4; // Text size n draws the font at n times 8x8
+
+class Renderer {
+public:
+    virtual ~Renderer() {}
+
+    virtual int getWidth() const = 0;
+    virtual int getHeight() const = 0;
+    int getMaxX() const { return getWidth() - 1; } // As getmaxx() in graphics.h
+    int getMaxY() const { return getHeight() - 1; }
+
+    virtual void clear(uint32_t color = PIXEL_BLACK) = 0;
+    // Filled rectangle, both corners included
+    virtual void bar(int left, int top, int right, int bottom, uint32_t color) = 0;
+    virtual void rectangle(int left, int top, int right, int bottom, uint32_t color) = 0;
+    virtual void line(int x0, int y0, int x1, int y1, uint32_t color, int thickness = 1) = 0;
+    // Text with its top-left corner at (x, y); the background shows through
+    virtual void text(int x, int y, const std::string &s, uint32_t color, int size) = 0;
+    virtual int textWidth(const std::string &s, int size) const = 0;
+    virtual int textHeight(int size) const = 0;
+
+    // Show what has been drawn since the last present
+    virtual void present() = 0;
+};
+
+// Receives finished frames, width x height pixels with rows top to bottom
+class FrameSink {
+public:
+    virtual ~FrameSink() {}
+    virtual void show(const uint32_t *pixels, int width, int height) = 0;
+};
+
+// 8x8 bitmap font for ' ' to '~', one byte per row, lowest bit leftmost
+inline constexpr uint8_t FONT_8X8[95][8] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00}, // !
+    {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00}, // #
+    {0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00}, // $
+    {0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00}, // %
+    {0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00}, // &
+    {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00}, // (
+    {0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00}, // )
+    {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00}, // *
+    {0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00}, // +
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ,
+    {0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00}, // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // .
+    {0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00}, // /
+    {0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00}, // 0
+    {0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00}, // 1
+    {0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00}, // 2
+    {0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00}, // 3
+    {0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00}, // 4
+    {0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00}, // 5
+    {0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00}, // 6
+    {0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00}, // 7
+    {0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00}, // 8
+    {0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00}, // 9
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // :
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ;
+    {0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00}, // <
+    {0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00}, // =
+    {0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00}, // >
+    {0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00}, // ?
+    {0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00}, // @
+    {0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00}, // A
+    {0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00}, // B
+    {0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00}, // C
+    {0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00}, // D
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00}, // E
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00}, // F
+    {0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00}, // G
+    {0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00}, // H
+    {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // I
+    {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00}, // J
+    {0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00}, // K
+    {0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00}, // L
+    {0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00}, // M
+    {0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00}, // N
+    {0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00}, // O
+    {0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00}, // P
+    {0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00}, // Q
+    {0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00}, // R
+    {0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00}, // S
+    {0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // T
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00}, // U
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // V
+    {0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00}, // W
+    {0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00}, // X
+    {0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00}, // Y
+    {0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00}, // Z
+    {0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00}, // [
+    {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00}, // backslash
+    {0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00}, // ]
+    {0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // _
+    {0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // `
+    {0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00}, // a
+    {0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00}, // b
+    {0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00}, // c
+    {0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00}, // d
+    {0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00}, // e
+    {0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00}, // f
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // g
+    {0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00}, // h
+    {0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // i
+    {0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E}, // j
+    {0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00}, // k
+    {0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // l
+    {0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00}, // m
+    {0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00}, // n
+    {0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00}, // o
+    {0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F}, // p
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78}, // q
+    {0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00}, // r
+    {0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00}, // s
+    {0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00}, // t
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00}, // u
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // v
+    {0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00}, // w
+    {0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00}, // x
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // y
+    {0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00}, // z
+    {0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00}, // {
+    {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00}, // |
+    {0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00}, // }
+    {0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ~
+};
+
+class SoftwareRenderer : public Renderer {
+private:
+    int width, height;
+    std::vector<uint32_t> pixels;
+    FrameSink *sink;
+    bool dirty; // Drawn since the last present
+
+    // Glyph atlas per text size: glyph g at size s is (8s)^2 mask words,
+    // all ones where the glyph has ink, starting at word g * (8s)^2
+    std::vector<uint32_t> atlas[MAX_TEXT_SIZE + 1];
+
+    static int clampSize(int size) { return std::max(1, std::min(MAX_TEXT_SIZE, size)); }
+
+    const std::vector<uint32_t> &glyphs(int size) {
+        std::vector<uint32_t> &masks = atlas[size];
+        if (!masks.empty()) return masks;
+        int side = 8 * size;
+        masks.assign(95 * side * side, 0);
+        for (int g = 0; g < 95; ++g) {
+            uint32_t *glyph = &masks[g * side * side];
+            for (int y = 0; y < side; ++y) {
+                for (int x = 0; x < side; ++x) {
+                    if (FONT_8X8[g][y / size] >> (x / size) & 1) glyph[y * side + x] = 0xFFFFFFFFu;
+                }
+            }
+        }
+        return masks;
+    }
+
+    // Set count pixels from row on to color
+    static void fillSpan(uint32_t *row, int count, uint32_t color) {
+        int i = 0;
+#ifdef RENDER_SSE2
+        __m128i fill = _mm_set1_epi32((int)color);
+        for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i *)(row + i), fill);
+#endif
+        for (; i < count; ++i) row[i] = color;
+    }
+
+    // Set the pixels from row on whose mask word is all ones to color
+    static void stampSpan(uint32_t *row, const uint32_t *mask, int count, uint32_t color) {
+        int i = 0;
+#ifdef RENDER_SSE2
+        __m128i ink = _mm_set1_epi32((int)color);
+        for (; i + 4 <= count; i += 4) {
+            __m128i m = _mm_loadu_si128((const __m128i *)(mask + i));
+            __m128i d = _mm_loadu_si128((const __m128i *)(row + i));
+            _mm_storeu_si128((__m128i *)(row + i), _mm_or_si128(_mm_andnot_si128(m, d), _mm_and_si128(m, ink)));
+        }
+#endif
+        for (; i < count; ++i) row[i] = (row[i] & ~mask[i]) | (color & mask[i]);
+    }
+
+    static void appendBigEndian(std::vector<uint8_t> &out, uint32_t v) {
+        for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(v >> shift));
+    }
+
+    static uint32_t crc32(const uint8_t *data, size_t size) {
+        static uint32_t table[256];
+        static bool ready = false;
+        if (!ready) {
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                table[n] = c;
+            }
+            ready = true;
+        }
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    // Length, type, data and CRC of one PNG chunk
+    static void appendChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+        appendBigEndian(out, (uint32_t)data.size());
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        appendBigEndian(out, crc32(&out[start], out.size() - start));
+    }
+
+public:
+    SoftwareRenderer(int w, int h, FrameSink *s = nullptr) : width(0), height(0), sink(s), dirty(false) {
+        resize(w, h);
+    }
+
+    // Change the framebuffer size; the new frame is black
+    void resize(int w, int h) {
+        width = std::max(1, w);
+        height = std::max(1, h);
+        pixels.assign((size_t)width * height, PIXEL_BLACK);
+        dirty = true;
+    }
+
+    void setSink(FrameSink *s) { sink = s; }
+
+    int getWidth() const override { return width; }
+    int getHeight() const override { return height; }
+    const uint32_t *getPixels() const { return pixels.data(); }
+    uint32_t getPixel(int x, int y) const { return pixels[(size_t)y * width + x]; }
+
+    void clear(uint32_t color = PIXEL_BLACK) override {
+        fillSpan(pixels.data(), width * height, color);
+        dirty = true;
+    }
+
+    void bar(int left, int top, int right, int bottom, uint32_t color) override {
+        if (left > right) std::swap(left, right);
+        if (top > bottom) std::swap(top, bottom);
+        left = std::max(left, 0);
+        top = std::max(top, 0);
+        right = std::min(right, width - 1);
+        bottom = std::min(bottom, height - 1);
+        if (left > right || top > bottom) return;
+        for (int y = top; y <= bottom; ++y) fillSpan(&pixels[(size_t)y * width + left], right - left + 1, color);
+        dirty = true;
+    }
+
+    void rectangle(int left, int top, int right, int bottom, uint32_t color) override {
+        bar(left, top, right, top, color);
+        bar(left, bottom, right, bottom, color);
+        bar(left, top, left, bottom, color);
+        bar(right, top, right, bottom, color);
+    }
+
+    // Straight lines are bars; others are Bresenham steps of thickness-wide squares
+    void line(int x0, int y0, int x1, int y1, uint32_t color, int thickness = 1) override {
+        int low = (thickness - 1) / 2, high = thickness / 2;
+        if (x0 == x1 || y0 == y1) {
+            bar(std::min(x0, x1) - low, std::min(y0, y1) - low, std::max(x0, x1) + high, std::max(y0, y1) + high, color);
+            return;
+        }
+        int dx = std::abs(x1 - x0), dy = -std::abs(y1 - y0);
+        int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+        int error = dx + dy;
+        while (true) {
+            bar(x0 - low, y0 - low, x0 + high, y0 + high, color);
+            if (x0 == x1 && y0 == y1) break;
+            int twice = 2 * error;
+            if (twice >= dy) {
+                error += dy;
+                x0 += sx;
+            }
+            if (twice <= dx) {
+                error += dx;
+                y0 += sy;
+            }
+        }
+    }
+
+    void text(int x, int y, const std::string &s, uint32_t color, int size) override {
+        size = clampSize(size);
+        int side = 8 * size;
+        const std::vector<uint32_t> &masks = glyphs(size);
+        int top = std::max(y, 0), bottom = std::min(y + side, height);
+        for (size_t i = 0; i < s.size(); ++i, x += side) {
+            int g = (s[i] >= ' ' && s[i] <= '~') ? s[i] - ' ' : '?' - ' ';
+            if (g == 0) continue;
+            int left = std::max(x, 0), right = std::min(x + side, width);
+            if (left >= right) continue;
+            const uint32_t *glyph = &masks[g * side * side];
+            for (int row = top; row < bottom; ++row) {
+                stampSpan(&pixels[(size_t)row * width + left], glyph + (row - y) * side + (left - x), right - left, color);
+            }
+            dirty = true;
+        }
+    }
+
+    int textWidth(const std::string &s, int size) const override { return (int)s.size() * 8 * clampSize(size); }
+    int textHeight(int size) const override { return 8 * clampSize(size); }
+
+    void present() override {
+        if (!dirty) return;
+        repaint();
+    }
+
+    // Show the frame even if nothing changed, e.g. after the window was covered
+    void repaint() {
+        if (sink) sink->show(pixels.data(), width, height);
+        dirty = false;
+    }
+
+    // FNV-1a over the pixels, to compare frames without storing them
+    uint64_t checksum() const {
+        uint64_t hash = 14695981039346656037ull;
+        for (uint32_t p : pixels) {
+            hash ^= p;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Write the frame as an RGBA PNG. The image data is stored uncompressed
+    // (deflate stored blocks), which needs no zlib.
+    bool savePng(const std::string &path) const {
+        std::vector<uint8_t> raw;
+        raw.reserve((size_t)height * (width * 4 + 1));
+        for (int y = 0; y < height; ++y) {
+            raw.push_back(0); // Filter type: none
+            for (int x = 0; x < width; ++x) {
+                uint32_t p = pixels[(size_t)y * width + x];
+                raw.push_back((uint8_t)(p >> 16));
+                raw.push_back((uint8_t)(p >> 8));
+                raw.push_back((uint8_t)p);
+                raw.push_back((uint8_t)(p >> 24));
+            }
+        }
+
+        std::vector<uint8_t> zlib = {0x78, 0x01};
+        uint32_t a = 1, b = 0; // Adler-32
+        size_t pos = 0;
+        bool last = false;
+        while (!last) {
+            size_t size = std::min<size_t>(65535, raw.size() - pos);
+            last = pos + size == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back((uint8_t)size);
+            zlib.push_back((uint8_t)(size >> 8));
+            zlib.push_back((uint8_t)~size);
+            zlib.push_back((uint8_t)(~size >> 8));
+            for (size_t i = pos; i < pos + size; ++i) {
+                zlib.push_back(raw[i]);
+                a = (a + raw[i]) % 65521;
+                b = (b + a) % 65521;
+            }
+            pos += size;
+        }
+        appendBigEndian(zlib, b << 16 | a);
+
+        std::vector<uint8_t> header;
+        appendBigEndian(header, (uint32_t)width);
+        appendBigEndian(header, (uint32_t)height);
+        header.insert(header.end(), {8, 6, 0, 0, 0}); // 8 bits per channel, RGBA, no interlace
+
+        std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        appendChunk(png, "IHDR", header);
+        appendChunk(png, "IDAT", zlib);
+        appendChunk(png, "IEND", {});
+
+        FILE *file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+        if (fclose(file) != 0) ok = false;
+        return ok;
+    }
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <map>
+#include "engine.h"
+#include "record.h"
+
+using namespace std;
+
+// Streams game records, replays every move on a Grid and prints a summary.
+// Usage: replay games.ttr [more.ttr ...]
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cout << "Usage: replay games.ttr [more.ttr ...]" << endl;
+        return 1;
+    }
+
+    long long games = 0, moves = 0, botMoves = 0, totalNodes = 0, totalMicros = 0, badGames = 0;
+    long long wins[2] = {0, 0}, draws = 0;
+    map<string, long long> timeControls; // Games per TimeControl::describe()
+    unique_ptr<Grid> grid;
+    auto start = chrono::steady_clock::now();
+
+    for (int i = 1; i < argc; ++i) {
+        GameRecordReader reader;
+        if (!reader.open(argv[i])) {
+            cout << "Could not read " << argv[i] << endl;
+            continue;
+        }
+
+        GameHeader header;
+        while (reader.nextGame(header)) {
+            if (!grid || grid->getRows() != header.rows || grid->getCols() != header.cols ||
+                grid->getWinLength() != header.winLength) {
+                grid.reset(new Grid(header.rows, header.cols, header.winLength));
+            } else {
+                grid->clearGrid();
+            }
+            GameLogic gameLogic(*grid);
+            timeControls[header.timeControl.describe()]++;
+
+            // Replay the moves and check the recorded result against the rules
+            MoveRecord m;
+            char player = 'O', winner = 'D';
+            bool corrupt = false;
+            while (reader.nextMove(m)) {
+                if (m.row >= header.rows || !grid->isCellEmpty(m.row, m.col)) {
+                    corrupt = true;
+                    continue;
+                }
+                grid->makeMove(m.row, m.col, player);
+                if (gameLogic.checkWinner(m.row, m.col).hasWinner) winner = player;
+                if (m.nodes > 0) {
+                    botMoves++;
+                    totalNodes += m.nodes;
+                    totalMicros += m.searchMicros;
+                }
+                player = (player == 'O') ? 'X' : 'O';
+                moves++;
+            }
+
+            char result = reader.getResult();
+            if (result == ' ') corrupt = true; // The move list did not end cleanly
+            if (result == 'O') wins[0]++;
+            else if (result == 'X') wins[1]++;
+            else draws++;
+            // A timeout can end the game without k in a row
+            if (corrupt || (winner != 'D' && winner != result)) badGames++;
+            games++;
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Games: " << games << " (O wins " << wins[0] << ", X wins " << wins[1] << ", draws/other " << draws << ")" << endl;
+    cout << "Moves: " << moves << ", replayed at " << (long long)(moves / max(seconds, 1e-9)) << " moves/s" << endl;
+    if (!timeControls.empty()) {
+        cout << "Time controls:";
+        for (const auto &entry : timeControls) cout << " " << entry.first << " (" << entry.second << ")";
+        cout << endl;
+    }
+    if (botMoves > 0) {
+        cout << "Bot moves: " << botMoves << ", avg " << totalNodes / botMoves << " nodes, "
+             << totalMicros / botMoves << " us" << endl;
+    }
+    if (badGames > 0) cout << "Corrupt games or results that disagree with the board: " << badGames << endl;
+    return badGames > 0 ? 1 : 0;
+}
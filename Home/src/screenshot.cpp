@@ -0,0 +1,140 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "views.h"
+
+using namespace std;
+
+// Draws one of the game's screens with the software renderer, without a
+// window, and writes it as a PNG file. It prints a checksum of the pixels,
+// so screenshot tests can compare frames without storing images, and the
+// time of a full redraw of the screen averaged over --frames redraws.
+// The game screens are set up by letting two bots play --moves moves.
+// The window is the smallest that fits the screen, or --width x --height as
+// the game's window on a given monitor.
+// Usage: screenshot [--scene game|hints|infinite|menu|timer|mode|names] [--rows R] [--cols C] [--win K]
+//                   [--moves N] [--frames N] [--width W] [--height H] [--out file.png]
+
+struct Options {
+    string scene = "game";
+    int rows = 15, cols = 15, winLength = DEFAULT_WIN_LENGTH;
+    int moves = 20;
+    int frames = 100;
+    int width = 0, height = 0; // 0 for the smallest window that fits
+    string out = "screenshot.png";
+};
+
+// Play up to count moves with a depth-1 bot on each side; the game may end earlier
+WinSequence playMoves(Grid &grid, int count) {
+    BotManager botO(grid, 'O'), botX(grid, 'X');
+    for (BotManager *bot : {&botO, &botX}) {
+        bot->setSearchDepth(1);
+        bot->setVerbose(false);
+    }
+    GameLogic gameLogic(grid);
+    for (int i = 0; i < count && !grid.isFull(); ++i) {
+        BotManager &bot = (i % 2 == 0) ? botO : botX;
+        bot.makeMove();
+        WinSequence win = gameLogic.checkWinner(bot.getLastRow(), bot.getLastCol());
+        if (win.hasWinner) return win;
+    }
+    return {false, -1, -1, -1, -1};
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i], value = argv[i + 1];
+        if (arg == "--scene") options.scene = value;
+        else if (arg == "--rows") options.rows = stoi(value);
+        else if (arg == "--cols") options.cols = stoi(value);
+        else if (arg == "--win") options.winLength = stoi(value);
+        else if (arg == "--moves") options.moves = stoi(value);
+        else if (arg == "--frames") options.frames = stoi(value);
+        else if (arg == "--width") options.width = stoi(value);
+        else if (arg == "--height") options.height = stoi(value);
+        else if (arg == "--out") options.out = value;
+        else {
+            cout << "Unknown option " << arg << endl;
+            return 1;
+        }
+    }
+    if (options.winLength < MIN_WIN_LENGTH || options.winLength > MAX_WIN_LENGTH ||
+        options.rows < options.winLength || options.cols < options.winLength) {
+        cout << "Need " << MIN_WIN_LENGTH << " <= k <= " << MAX_WIN_LENGTH << " and a board at least k x k" << endl;
+        return 1;
+    }
+
+    bool game = options.scene == "game" || options.scene == "hints";
+    int width = options.width > 0 ? options.width : game ? max(options.cols * CELL_SIZE + 40, 400) : MENU_WIDTH;
+    int height = options.height > 0 ? options.height : game ? options.rows * CELL_SIZE + 190 : options.scene == "infinite" ? 720 : MENU_HEIGHT;
+    SoftwareRenderer screen(width, height);
+
+    Grid grid(options.rows, options.cols, options.winLength);
+    SparseBoard board(options.winLength);
+    InfiniteView infiniteView(board, screen);
+    WinSequence win = {false, -1, -1, -1, -1};
+    vector<AnalysisLine> hints;
+    if (game) {
+        win = playMoves(grid, options.moves);
+        if (options.scene == "hints" && !win.hasWinner && !grid.isFull()) {
+            char side = grid.getMoveCount() % 2 == 0 ? 'O' : 'X';
+            BotManager analyst(grid, side);
+            analyst.setVerbose(false);
+            hints = analyst.analyze(side, 3, 2);
+        }
+    } else if (options.scene == "infinite") {
+        Grid window(options.rows, options.cols, options.winLength);
+        win = playMoves(window, options.moves);
+        for (int i = 0; i < window.getMoveCount(); ++i) {
+            int row = window.getMoveRow(i), col = window.getMoveCol(i);
+            board.makeMove(row - options.rows / 2, col - options.cols / 2, window.getCell(row, col));
+        }
+        if (win.hasWinner) {
+            win = {true, win.startRow - options.rows / 2, win.startCol - options.cols / 2,
+                   win.endRow - options.rows / 2, win.endCol - options.cols / 2};
+        }
+    } else if (options.scene != "menu" && options.scene != "timer" && options.scene != "mode" && options.scene != "names") {
+        cout << "Unknown scene " << options.scene << endl;
+        return 1;
+    }
+
+    GridView gridView(grid, screen);
+    auto draw = [&]() {
+        screen.clear();
+        if (game) {
+            gridView.drawGrid();
+            if (win.hasWinner) gridView.drawWinningLine(win.startRow, win.startCol, win.endRow, win.endCol);
+            gridView.drawHints(hints);
+            drawPlayerNames(screen, "Alice", "Bot");
+            drawTimer(screen, "Time Left: 30s", screen.getMaxY() - screen.textHeight(2) - 20);
+        } else if (options.scene == "infinite") {
+            infiniteView.draw();
+            if (win.hasWinner) infiniteView.drawWinningLine(win);
+            drawPlayerNames(screen, "Alice", "Bot");
+            drawTimer(screen, "Time Left: 30s", 30);
+        } else if (options.scene == "menu") {
+            GameMenu::drawMenu(screen, options.rows, options.cols, options.winLength);
+        } else if (options.scene == "timer") {
+            GameMenu::drawTimerMenu(screen);
+        } else if (options.scene == "mode") {
+            GameMenu::drawGameModeMenu(screen);
+        } else {
+            GameMenu::drawNameInputMenu(screen, "Alice", "", 1, false);
+        }
+    };
+
+    draw(); // Builds the glyph atlas before timing
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < options.frames; ++i) draw();
+    double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    if (!screen.savePng(options.out)) {
+        cout << "Could not write " << options.out << endl;
+        return 1;
+    }
+    cout << options.scene << " " << width << "x" << height << ": checksum " << screen.checksum() << ", "
+         << (options.frames ? micros / options.frames : 0.0) << " us per frame, wrote " << options.out << endl;
+    return 0;
+}
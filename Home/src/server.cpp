@@ -0,0 +1,675 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "engine.h"
+#include "slab.h"
+#include "snapshot.h"
+
+using namespace std;
+
+// Headless game server: hosts many games against the bot over TCP or a Unix socket.
+// One epoll loop owns all sockets and games; bot moves run on a bounded worker pool.
+// When the pool's queue is full the server stops reading from the clients that need
+// it, so TCP flow control pushes back on them until a worker frees up.
+//
+// Protocol, one command per line:
+//   NEW <rows> <cols> [O|X] [k]
+//                             start a game, the bot plays the given side (default X)
+//                             and k in a row wins (default 5)
+//                             -> GAME <id>, followed by BOT if the bot moves first
+//   MOVE <id> <row> <col>     play a move for the human side
+//                             -> BOT <id> <row> <col> once the bot has answered
+//   RESUME <id>               take over a game restored from a snapshot -> GAME <id>
+//   BOARD <id>                -> BOARD <id> <cells row by row, '.' for empty>
+//   END <id>                  -> ENDED <id>
+//   STATS                     -> STATS <key>=<value> ...; bytes_per_game counts the
+//                             slabs and shared line tables, not the search table
+// A finished game is reported as OVER <id> <O|X|D>; errors as ERR <reason>.
+//
+// With --snapshot, SIGTERM or SIGINT makes the server let running bot moves
+// finish, then save every game and the transposition table to the file and
+// exit; the next start restores them, and clients RESUME their games.
+//
+// Usage: server [--port N | --unix PATH] [--workers N] [--queue N] [--depth N] [--table ENTRIES]
+//               [--snapshot PATH]
+
+const int MAX_BOARD_SIZE = 30;
+const size_t SLOTS_PER_SLAB = 256;
+
+struct ServerOptions {
+    int port = 7070;
+    string unixPath;
+    int workers = max(1u, thread::hardware_concurrency());
+    int queueSize = 256;
+    int depth = 2;
+    size_t tableEntries = 1 << 20; // 16 MB transposition table
+    string snapshotPath;
+};
+
+// One hosted game. The main loop owns it except while busy, when a worker searches it.
+// A game's own state lives in its slab slot: the ServerGame itself (grid, win checks
+// and bot settings) followed by the grid's cells. Line tables are shared by the games
+// of one board shape, search scratch belongs to the worker threads and the
+// transposition table to the server.
+struct ServerGame {
+    int id;
+    int ownerFd;
+    Grid grid;
+    GameLogic gameLogic;
+    BotManager bot;
+    PlayerManager playerManager;
+    char botSymbol;
+    bool busy;
+    bool over;
+    bool orphaned; // Owner disconnected while a worker had the game
+
+    ServerGame(int gameId, int fd, int rows, int cols, int winLength, char symbol, int depth, char *cells,
+               TranspositionTable *table)
+        : id(gameId), ownerFd(fd), grid(rows, cols, winLength, cells), gameLogic(grid), bot(grid, symbol, EvalWeights::defaults(), table),
+          botSymbol(symbol), busy(false), over(false), orphaned(false) {
+        bot.setSearchDepth(depth);
+        bot.setVerbose(false);
+    }
+
+    static size_t slotSize() {
+        return sizeof(ServerGame) + Grid::storageSize(MAX_BOARD_SIZE, MAX_BOARD_SIZE);
+    }
+
+    static ServerGame *create(SlabAllocator &slab, int gameId, int fd, int rows, int cols, int winLength, char symbol,
+                              int depth, TranspositionTable *table) {
+        void *slot = slab.allocate();
+        char *cells = static_cast<char *>(slot) + sizeof(ServerGame);
+        return new (slot) ServerGame(gameId, fd, rows, cols, winLength, symbol, depth, cells, table);
+    }
+
+    static void destroy(SlabAllocator &slab, ServerGame *game) {
+        game->~ServerGame();
+        slab.release(game);
+    }
+};
+
+// Fixed set of threads computing bot moves from a bounded queue
+class WorkerPool {
+private:
+    vector<thread> threads;
+    deque<ServerGame *> jobs;
+    vector<ServerGame *> finished;
+    mutex lock;
+    condition_variable wake;
+    size_t capacity;
+    int notifyFd; // eventfd signalled whenever a job finishes
+    bool stopping;
+
+    void work() {
+        while (true) {
+            ServerGame *game;
+            {
+                unique_lock<mutex> guard(lock);
+                wake.wait(guard, [this]() { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                game = jobs.front();
+                jobs.pop_front();
+            }
+
+            game->bot.makeMove();
+
+            {
+                lock_guard<mutex> guard(lock);
+                finished.push_back(game);
+            }
+            uint64_t one = 1;
+            if (write(notifyFd, &one, sizeof(one)) < 0) perror("eventfd write");
+        }
+    }
+
+public:
+    WorkerPool(int count, size_t queueCapacity, int fd) : capacity(queueCapacity), notifyFd(fd), stopping(false) {
+        for (int i = 0; i < count; ++i) threads.emplace_back(&WorkerPool::work, this);
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &t : threads) t.join();
+    }
+
+    bool hasRoom() {
+        lock_guard<mutex> guard(lock);
+        return jobs.size() < capacity;
+    }
+
+    size_t queued() {
+        lock_guard<mutex> guard(lock);
+        return jobs.size();
+    }
+
+    void submit(ServerGame *game) {
+        {
+            lock_guard<mutex> guard(lock);
+            jobs.push_back(game);
+        }
+        wake.notify_one();
+    }
+
+    vector<ServerGame *> takeFinished() {
+        lock_guard<mutex> guard(lock);
+        vector<ServerGame *> result;
+        result.swap(finished);
+        return result;
+    }
+};
+
+struct Connection {
+    int fd;
+    string in, out;
+    bool stalled;     // Waiting for room in the worker queue
+    bool writing;     // EPOLLOUT is enabled
+    vector<int> games;
+};
+
+class GameServer {
+private:
+    ServerOptions options;
+    int listenFd, epollFd, notifyFd, signalFd;
+    bool draining; // Shutting down once the running bot moves are done
+    unique_ptr<WorkerPool> pool;
+    unordered_map<int, unique_ptr<Connection>> connections;
+    SlabAllocator gameSlab;
+    TranspositionTable searchTable; // Shared by the bots of all games
+    unordered_map<int, ServerGame *> games;
+    vector<int> stalledFds;
+    int nextGameId;
+    long long botMoves, stalls;
+
+    static void setNonBlocking(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    void updateEvents(Connection &conn) {
+        epoll_event ev = {};
+        ev.events = (conn.stalled ? 0u : (uint32_t)EPOLLIN) | (conn.writing ? (uint32_t)EPOLLOUT : 0u);
+        ev.data.fd = conn.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev);
+    }
+
+    void send(Connection &conn, const string &line) {
+        conn.out += line;
+        conn.out += '\n';
+    }
+
+    void sendToOwner(const ServerGame &game, const string &line) {
+        auto it = connections.find(game.ownerFd);
+        if (it != connections.end()) {
+            send(*it->second, line);
+            flush(*it->second);
+        }
+    }
+
+    void flush(Connection &conn) {
+        while (!conn.out.empty()) {
+            ssize_t n = ::send(conn.fd, conn.out.data(), conn.out.size(), MSG_NOSIGNAL);
+            if (n <= 0) break;
+            conn.out.erase(0, n);
+        }
+        bool wantWrite = !conn.out.empty();
+        if (wantWrite != conn.writing) {
+            conn.writing = wantWrite;
+            updateEvents(conn);
+        }
+    }
+
+    ServerGame *findGame(Connection &conn, int id) {
+        auto it = games.find(id);
+        if (it == games.end() || it->second->ownerFd != conn.fd) return nullptr;
+        return it->second;
+    }
+
+    void endGame(int id) {
+        auto it = games.find(id);
+        if (it == games.end()) return;
+        if (it->second->busy) {
+            it->second->orphaned = true; // Freed when the worker hands it back
+            it->second->ownerFd = -1;
+        } else {
+            ServerGame::destroy(gameSlab, it->second);
+            games.erase(it);
+        }
+    }
+
+    // Memory of the games themselves per live game: their slabs and the line
+    // tables they share; 0 without games
+    size_t bytesPerGame() const {
+        if (games.empty()) return 0;
+        return (gameSlab.getReservedBytes() + LineTable::sharedBytes()) / games.size();
+    }
+
+    void startBotMove(ServerGame &game) {
+        game.busy = true;
+        pool->submit(&game);
+    }
+
+    // Report the result if the last move at (row, col) ended the game
+    bool checkGameOver(ServerGame &game, int row, int col) {
+        char result = ' ';
+        if (game.gameLogic.checkWinner(row, col).hasWinner) {
+            result = game.grid.getCell(row, col);
+        } else if (game.grid.isFull()) {
+            result = 'D';
+        }
+        if (result == ' ') return false;
+        game.over = true;
+        sendToOwner(game, "OVER " + to_string(game.id) + " " + result);
+        return true;
+    }
+
+    // Returns false if the command must wait for room in the worker queue
+    bool handleCommand(Connection &conn, const string &line) {
+        istringstream args(line);
+        string command;
+        args >> command;
+
+        if (command == "NEW") {
+            int rows = 0, cols = 0, winLength = DEFAULT_WIN_LENGTH;
+            string side = "X";
+            args >> rows >> cols >> side >> winLength;
+            if (rows < MIN_WIN_LENGTH || rows > MAX_BOARD_SIZE || cols < MIN_WIN_LENGTH || cols > MAX_BOARD_SIZE ||
+                (side != "O" && side != "X") || winLength < MIN_WIN_LENGTH || winLength > MAX_WIN_LENGTH) {
+                send(conn, "ERR bad NEW arguments");
+                return true;
+            }
+            char botSymbol = side[0];
+            if (botSymbol == 'O' && !pool->hasRoom()) return false;
+
+            int id = nextGameId++;
+            games[id] = ServerGame::create(gameSlab, id, conn.fd, rows, cols, winLength, botSymbol, options.depth,
+                                           &searchTable);
+            conn.games.push_back(id);
+            send(conn, "GAME " + to_string(id));
+            if (botSymbol == 'O') startBotMove(*games[id]);
+        } else if (command == "MOVE") {
+            int id = -1, row = -1, col = -1;
+            args >> id >> row >> col;
+            ServerGame *game = findGame(conn, id);
+            if (!game) {
+                send(conn, "ERR unknown game " + to_string(id));
+            } else if (game->busy) {
+                send(conn, "ERR " + to_string(id) + " bot is thinking");
+            } else if (game->over) {
+                send(conn, "ERR " + to_string(id) + " game is over");
+            } else if (row < 0 || row >= game->grid.getRows() || col < 0 || col >= game->grid.getCols() ||
+                       !game->grid.isCellEmpty(row, col)) {
+                send(conn, "ERR " + to_string(id) + " illegal move");
+            } else {
+                if (!pool->hasRoom()) return false;
+                game->grid.makeMove(row, col, game->playerManager.getCurrentPlayer());
+                if (!checkGameOver(*game, row, col)) {
+                    game->playerManager.switchPlayer();
+                    startBotMove(*game);
+                }
+            }
+        } else if (command == "RESUME") {
+            int id = -1;
+            args >> id;
+            auto it = games.find(id);
+            if (it == games.end() || it->second->ownerFd != -1 || it->second->orphaned) {
+                send(conn, "ERR cannot resume " + to_string(id));
+            } else {
+                it->second->ownerFd = conn.fd;
+                conn.games.push_back(id);
+                send(conn, "GAME " + to_string(id));
+            }
+        } else if (command == "BOARD") {
+            int id = -1;
+            args >> id;
+            ServerGame *game = findGame(conn, id);
+            if (!game || game->busy) {
+                send(conn, "ERR board unavailable for " + to_string(id));
+            } else {
+                string cells;
+                for (int r = 0; r < game->grid.getRows(); ++r) {
+                    for (int c = 0; c < game->grid.getCols(); ++c) {
+                        cells += game->grid.isCellEmpty(r, c) ? '.' : game->grid.getCell(r, c);
+                    }
+                }
+                send(conn, "BOARD " + to_string(id) + " " + cells);
+            }
+        } else if (command == "END") {
+            int id = -1;
+            args >> id;
+            if (!findGame(conn, id)) {
+                send(conn, "ERR unknown game " + to_string(id));
+            } else {
+                endGame(id);
+                conn.games.erase(remove(conn.games.begin(), conn.games.end(), id), conn.games.end());
+                send(conn, "ENDED " + to_string(id));
+            }
+        } else if (command == "STATS") {
+            send(conn, "STATS games=" + to_string(games.size()) + " connections=" + to_string(connections.size()) +
+                       " queued=" + to_string(pool->queued()) + " bot_moves=" + to_string(botMoves) +
+                       " stalls=" + to_string(stalls) + " slot_bytes=" + to_string(gameSlab.getSlotSize()) +
+                       " slabs=" + to_string(gameSlab.getSlabCount()) +
+                       " reserved_bytes=" + to_string(gameSlab.getReservedBytes()) +
+                       " line_table_bytes=" + to_string(LineTable::sharedBytes()) +
+                       " bytes_per_game=" + to_string(bytesPerGame()));
+        } else if (!command.empty()) {
+            send(conn, "ERR unknown command " + command);
+        }
+        return true;
+    }
+
+    void processInput(Connection &conn) {
+        size_t start = 0, newline;
+        while ((newline = conn.in.find('\n', start)) != string::npos) {
+            string line = conn.in.substr(start, newline - start);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!handleCommand(conn, line)) {
+                // Backpressure: keep the line and stop reading until a worker is free
+                conn.stalled = true;
+                stalls++;
+                stalledFds.push_back(conn.fd);
+                updateEvents(conn);
+                break;
+            }
+            start = newline + 1;
+        }
+        conn.in.erase(0, start);
+        flush(conn);
+    }
+
+    void acceptClients() {
+        while (true) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) return;
+            setNonBlocking(fd);
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            Connection *conn = new Connection{fd, "", "", false, false, {}};
+            connections[fd].reset(conn);
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+
+    void closeConnection(int fd) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) return;
+        for (int id : it->second->games) endGame(id);
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(it);
+    }
+
+    void readClient(Connection &conn) {
+        char buffer[4096];
+        while (true) {
+            ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                conn.in.append(buffer, n);
+            } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                closeConnection(conn.fd);
+                return;
+            } else {
+                break;
+            }
+        }
+        processInput(conn);
+    }
+
+    // Apply bot moves handed back by the workers, then resume stalled clients
+    void collectBotMoves() {
+        uint64_t count;
+        if (read(notifyFd, &count, sizeof(count)) < 0) return;
+
+        for (ServerGame *game : pool->takeFinished()) {
+            game->busy = false;
+            botMoves++;
+            if (game->orphaned) {
+                games.erase(game->id);
+                ServerGame::destroy(gameSlab, game);
+                continue;
+            }
+
+            int row = game->bot.getLastRow(), col = game->bot.getLastCol();
+            if (row == -1) {
+                game->over = true;
+                sendToOwner(*game, "OVER " + to_string(game->id) + " D");
+            } else {
+                sendToOwner(*game, "BOT " + to_string(game->id) + " " + to_string(row) + " " + to_string(col));
+                if (!checkGameOver(*game, row, col)) game->playerManager.switchPlayer();
+            }
+        }
+
+        vector<int> resumed;
+        resumed.swap(stalledFds);
+        for (int fd : resumed) {
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+            it->second->stalled = false;
+            updateEvents(*it->second);
+            processInput(*it->second);
+        }
+    }
+
+public:
+    GameServer(const ServerOptions &opt)
+        : options(opt), listenFd(-1), epollFd(-1), notifyFd(-1), signalFd(-1), draining(false),
+          gameSlab(ServerGame::slotSize(), SLOTS_PER_SLAB), searchTable(opt.tableEntries), nextGameId(1), botMoves(0),
+          stalls(0) {}
+
+    // Bring back the games and search table of a snapshot. Restored games have
+    // no owner until a client sends RESUME.
+    void restoreSnapshot() {
+        SnapshotReader reader;
+        if (!reader.open(options.snapshotPath)) return;
+
+        const GameSnapshot *saved;
+        const char *storage;
+        int restored = 0, rejected = 0;
+        while (reader.nextGame(saved, storage)) {
+            if (saved->rows > MAX_BOARD_SIZE || saved->cols > MAX_BOARD_SIZE || saved->botSymbol == ' ' ||
+                games.count(saved->id) || !isRestorable(*saved, storage)) {
+                rejected++;
+                continue;
+            }
+            ServerGame *game = ServerGame::create(gameSlab, saved->id, -1, saved->rows, saved->cols, saved->winLength,
+                                                  saved->botSymbol, options.depth, &searchTable);
+            game->grid.restore(storage, saved->moveCount);
+            game->playerManager.setCurrentPlayer(saved->currentPlayer);
+            game->over = saved->over;
+            games[saved->id] = game;
+            nextGameId = max(nextGameId, saved->id + 1);
+            restored++;
+        }
+        bool warm = reader.restoreTable(searchTable);
+        cout << "Restored " << restored << " games" << (warm ? " and the search table" : "") << " from "
+             << options.snapshotPath << endl;
+        if (rejected > 0) cout << "Skipped " << rejected << " damaged games in the snapshot" << endl;
+    }
+
+    bool saveSnapshot() {
+        SnapshotWriter writer;
+        if (!writer.open(options.snapshotPath)) return false;
+        for (auto &entry : games) {
+            ServerGame &game = *entry.second;
+            if (game.orphaned) continue;
+            GameSnapshot saved = {game.id, game.grid.getRows(), game.grid.getCols(), game.grid.getMoveCount(),
+                                  game.playerManager.getCurrentPlayer(), game.botSymbol, game.over,
+                                  (char)game.grid.getWinLength(), 0, -1, 0, 0, {}}; // No level or clock on the server
+            writer.addGame(saved, game.grid);
+        }
+        writer.addTable(searchTable);
+        return writer.close();
+    }
+
+    bool start() {
+        if (options.unixPath.empty()) {
+            listenFd = socket(AF_INET, SOCK_STREAM, 0);
+            int one = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(options.port);
+            if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+                perror("bind");
+                return false;
+            }
+        } else {
+            listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr = {};
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, options.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+            unlink(options.unixPath.c_str());
+            if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+                perror("bind");
+                return false;
+            }
+        }
+        if (listen(listenFd, SOMAXCONN) < 0) {
+            perror("listen");
+            return false;
+        }
+        setNonBlocking(listenFd);
+
+        epollFd = epoll_create1(0);
+        notifyFd = eventfd(0, EFD_NONBLOCK);
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+
+        // Take SIGTERM and SIGINT through the loop to save a snapshot before
+        // exiting. Blocked before the workers start so they inherit the mask.
+        if (!options.snapshotPath.empty()) {
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGTERM);
+            sigaddset(&signals, SIGINT);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+            signalFd = signalfd(-1, &signals, SFD_NONBLOCK);
+            ev.data.fd = signalFd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &ev);
+            restoreSnapshot();
+        }
+        pool.reset(new WorkerPool(options.workers, options.queueSize, notifyFd));
+
+        ev.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+        ev.data.fd = notifyFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, notifyFd, &ev);
+        return true;
+    }
+
+    // Stop listening and reading; the clients will RESUME their games after the restart
+    void startDraining() {
+        draining = true;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+        for (auto &entry : connections) epoll_ctl(epollFd, EPOLL_CTL_DEL, entry.first, nullptr);
+        stalledFds.clear();
+        cout << "Shutting down, waiting for " << pool->queued() << " queued bot moves" << endl;
+    }
+
+    bool anyBusy() const {
+        for (auto &entry : games) {
+            if (entry.second->busy) return true;
+        }
+        return false;
+    }
+
+    // Returns after a shutdown signal, once the snapshot is saved
+    void run() {
+        epoll_event events[256];
+        while (!draining || anyBusy()) {
+            int n = epoll_wait(epollFd, events, 256, -1);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptClients();
+                } else if (fd == notifyFd) {
+                    collectBotMoves();
+                } else if (fd == signalFd) {
+                    signalfd_siginfo info;
+                    while (read(signalFd, &info, sizeof(info)) == sizeof(info)) {
+                        if (!draining) startDraining();
+                    }
+                } else if (!draining) {
+                    auto it = connections.find(fd);
+                    if (it == connections.end()) continue;
+                    Connection &conn = *it->second;
+                    if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                        closeConnection(fd);
+                        continue;
+                    }
+                    if (events[i].events & EPOLLOUT) flush(conn);
+                    if (events[i].events & EPOLLIN) readClient(conn);
+                }
+            }
+        }
+
+        if (saveSnapshot()) {
+            cout << "Saved " << games.size() << " games to " << options.snapshotPath << endl;
+        } else {
+            cout << "Could not save the snapshot to " << options.snapshotPath << endl;
+        }
+    }
+};
+
+bool parseOptions(int argc, char **argv, ServerOptions &opt) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i], value = argv[i + 1];
+        if (arg == "--port") opt.port = stoi(value);
+        else if (arg == "--unix") opt.unixPath = value;
+        else if (arg == "--workers") opt.workers = max(1, stoi(value));
+        else if (arg == "--queue") opt.queueSize = max(1, stoi(value));
+        else if (arg == "--depth") opt.depth = stoi(value);
+        else if (arg == "--table") opt.tableEntries = max(1, stoi(value));
+        else if (arg == "--snapshot") opt.snapshotPath = value;
+        else {
+            cout << "Unknown option " << arg << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cout << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    ServerOptions opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+    signal(SIGPIPE, SIG_IGN);
+
+    GameServer server(opt);
+    if (!server.start()) return 1;
+    cout << "Serving on " << (opt.unixPath.empty() ? "127.0.0.1:" + to_string(opt.port) : opt.unixPath)
+         << " with " << opt.workers << " workers" << endl;
+    server.run();
+    return 0;
+}
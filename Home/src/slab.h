@@ -0,0 +1,62 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+// Fixed-size slot allocator for hosting many games in one process.
+// Slots are carved out of large slabs, so thousands of sessions cost a
+// handful of allocations, sit next to each other in memory and are reused
+// as soon as a game ends.
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class SlabAllocator {
+private:
+    size_t slotSize, slotsPerSlab;
+    std::vector<std::unique_ptr<unsigned char[]>> slabs;
+    std::vector<void *> freeSlots;
+    size_t live;
+
+    void addSlab() {
+        slabs.emplace_back(new unsigned char[slotSize * slotsPerSlab]);
+        unsigned char *base = slabs.back().get();
+        // Push in reverse so slots are handed out in address order
+        for (size_t i = slotsPerSlab; i-- > 0;) freeSlots.push_back(base + i * slotSize);
+    }
+
+public:
+    SlabAllocator(size_t size, size_t perSlab)
+        : slotSize(roundUp(size)), slotsPerSlab(perSlab), live(0) {}
+
+    SlabAllocator(const SlabAllocator &) = delete;
+    SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+    // Slot sizes are kept a multiple of the strictest alignment
+    static size_t roundUp(size_t size) {
+        const size_t align = alignof(std::max_align_t);
+        return (size + align - 1) / align * align;
+    }
+
+    void *allocate() {
+        if (freeSlots.empty()) addSlab();
+        void *slot = freeSlots.back();
+        freeSlots.pop_back();
+        live++;
+        return slot;
+    }
+
+    void release(void *slot) {
+        freeSlots.push_back(slot);
+        live--;
+    }
+
+    size_t getSlotSize() const { return slotSize; }
+    size_t getLiveSlots() const { return live; }
+    size_t getSlabCount() const { return slabs.size(); }
+    size_t getReservedBytes() const { return slabs.size() * slotsPerSlab * slotSize; }
+
+    // Reserved memory per live slot; 0 when nothing is allocated
+    size_t getBytesPerSlot() const { return live ? getReservedBytes() / live : 0; }
+};
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+// Game and engine snapshots for warm restarts.
+//
+// A snapshot file is a fixed-layout image that is mapped into memory (read
+// into it on Windows) and copied back block by block, with nothing to parse:
+//   SnapshotHeader
+//   per game: GameSnapshot, then the grid's storage block (undo stack and
+//             cells, Grid::storageSize() bytes, padded to 8)
+//   the transposition table slots at tableOffset, two 64-bit words each
+//   (tableEntries is 0 when the snapshot has no table)
+// Snapshots are read back on the machine that wrote them, so fields are in
+// native byte order. A game's clock is saved with it when it has one (the
+// GUI's games; the server plays without clocks).
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "engine.h"
+#include "timecontrol.h"
+
+const uint32_t SNAPSHOT_MAGIC = 0x33535454; // "TTS3"; older files have no clock state and are not read
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t gameCount;
+    uint64_t tableEntries;
+    uint64_t tableOffset;
+    uint64_t fileSize;
+};
+
+// State of one game besides its grid
+struct GameSnapshot {
+    int32_t id;
+    int32_t rows, cols;
+    int32_t moveCount;   // Moves on the grid's undo stack
+    char currentPlayer;  // PlayerManager state
+    char botSymbol;      // ' ' when no bot plays
+    char over;
+    char winLength;
+    uint32_t storageBytes;
+    int32_t botLevel;    // Index in BOT_LEVELS, -1 when the bot plays at a fixed depth
+    int32_t hasClock;    // 1 when clock holds the game's clock
+    uint64_t botSeed;    // Evaluation noise seed of the bot's level
+    ClockState clock;
+};
+
+// Whether a game read from a snapshot can be restored: a side to move and a
+// bot side that exist, a level and clock that can be set, a board of at
+// least k x k with a k the engine supports, and a grid block Grid::restore()
+// can load. A stale or damaged file can pass the size checks of
+// SnapshotReader and still fail these.
+inline bool isRestorable(const GameSnapshot &game, const char *storage) {
+    if (game.currentPlayer != 'O' && game.currentPlayer != 'X') return false;
+    if (game.botSymbol != 'O' && game.botSymbol != 'X' && game.botSymbol != ' ') return false;
+    if (game.botLevel < -1 || game.botLevel >= BOT_LEVEL_COUNT) return false;
+    if (game.hasClock != 0 && (game.hasClock != 1 || !GameClock::isValidState(game.clock))) return false;
+    if (game.winLength < MIN_WIN_LENGTH || game.winLength > MAX_WIN_LENGTH) return false;
+    if (game.rows < game.winLength || game.cols < game.winLength) return false;
+    return Grid::isValidStorage(storage, game.rows, game.cols, game.moveCount);
+}
+
+// Grid blocks and the table start on 8-byte boundaries
+inline uint64_t snapshotPadded(uint64_t size) { return (size + 7) / 8 * 8; }
+
+// Writes a snapshot to a temporary file and renames it over the old one on
+// close(), so a crash while saving never leaves a torn snapshot behind
+class SnapshotWriter {
+private:
+    FILE *file;
+    std::string path;
+    SnapshotHeader header;
+    uint64_t offset;
+
+    void write(const void *data, size_t size) {
+        fwrite(data, 1, size, file);
+        offset += size;
+    }
+
+    void pad() {
+        static const char zeros[8] = {};
+        write(zeros, snapshotPadded(offset) - offset);
+    }
+
+public:
+    SnapshotWriter() : file(nullptr), header(), offset(0) {}
+
+    ~SnapshotWriter() {
+        if (file) fclose(file);
+    }
+
+    bool open(const std::string &snapshotPath) {
+        path = snapshotPath;
+        file = fopen((path + ".tmp").c_str(), "wb");
+        if (!file) return false;
+        header = {SNAPSHOT_MAGIC, 0, 0, 0, 0};
+        offset = 0;
+        write(&header, sizeof(header)); // Rewritten by close()
+        return true;
+    }
+
+    void addGame(const GameSnapshot &game, const Grid &grid) {
+        GameSnapshot entry = game;
+        entry.storageBytes = (uint32_t)Grid::storageSize(game.rows, game.cols);
+        write(&entry, sizeof(entry));
+        write(grid.getStorage(), entry.storageBytes);
+        pad();
+        header.gameCount++;
+    }
+
+    // Add the table's slots; call after the last addGame()
+    void addTable(const TranspositionTable &table) {
+        const size_t CHUNK = 1 << 14;
+        std::vector<uint64_t> words(2 * CHUNK);
+        header.tableEntries = table.size();
+        header.tableOffset = offset;
+        for (size_t first = 0; first < table.size(); first += CHUNK) {
+            size_t count = std::min(CHUNK, table.size() - first);
+            table.copyOut(first, count, words.data());
+            write(words.data(), count * 2 * sizeof(uint64_t));
+        }
+    }
+
+    bool close() {
+        if (!file) return false;
+        header.fileSize = offset;
+        fseek(file, 0, SEEK_SET);
+        fwrite(&header, 1, sizeof(header), file);
+        bool ok = (fflush(file) == 0 && !ferror(file));
+        fclose(file);
+        file = nullptr;
+#ifdef _WIN32
+        remove(path.c_str()); // rename() does not replace a file here
+#endif
+        return ok && rename((path + ".tmp").c_str(), path.c_str()) == 0;
+    }
+};
+
+// Maps a snapshot file read-only (reads it whole on Windows); nextGame()
+// walks the games in place
+class SnapshotReader {
+private:
+    const unsigned char *base;
+    size_t length;
+    size_t pos;
+    uint32_t gamesRead;
+#ifdef _WIN32
+    std::vector<unsigned char> data; // The file, when it cannot be mapped
+#endif
+
+    const SnapshotHeader &header() const { return *reinterpret_cast<const SnapshotHeader *>(base); }
+
+public:
+    SnapshotReader() : base(nullptr), length(0), pos(0), gamesRead(0) {}
+
+    ~SnapshotReader() { close(); }
+
+    SnapshotReader(const SnapshotReader &) = delete;
+    SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+    // False if the file is missing or is not a complete snapshot
+    bool open(const std::string &path) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(SnapshotHeader)) {
+            void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                base = static_cast<const unsigned char *>(map);
+                length = info.st_size;
+            }
+        }
+        ::close(fd);
+#else
+        FILE *file = fopen(path.c_str(), "rb");
+        if (!file) return false;
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (size >= (long)sizeof(SnapshotHeader)) {
+            data.resize(size);
+            if (fread(data.data(), 1, data.size(), file) == data.size()) {
+                base = data.data();
+                length = data.size();
+            }
+        }
+        fclose(file);
+#endif
+        if (!base) return false;
+
+        const SnapshotHeader &h = header();
+        if (h.magic != SNAPSHOT_MAGIC || h.fileSize != length ||
+            h.tableOffset + h.tableEntries * 2 * sizeof(uint64_t) > length) {
+            close();
+            return false;
+        }
+        pos = sizeof(SnapshotHeader);
+        gamesRead = 0;
+        return true;
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (base) munmap(const_cast<unsigned char *>(base), length);
+#else
+        data.clear();
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    // The next game and its grid block (for Grid::restore), or false after the last one
+    bool nextGame(const GameSnapshot *&game, const char *&storage) {
+        if (!base || gamesRead == header().gameCount || pos + sizeof(GameSnapshot) > length) return false;
+        game = reinterpret_cast<const GameSnapshot *>(base + pos);
+        if (game->storageBytes != Grid::storageSize(game->rows, game->cols) ||
+            pos + sizeof(GameSnapshot) + game->storageBytes > length) {
+            return false;
+        }
+        storage = reinterpret_cast<const char *>(base + pos + sizeof(GameSnapshot));
+        pos = snapshotPadded(pos + sizeof(GameSnapshot) + game->storageBytes);
+        gamesRead++;
+        return true;
+    }
+
+    // Load the saved slots into table; false when there are none or the sizes differ
+    bool restoreTable(TranspositionTable &table) const {
+        if (!base || header().tableEntries == 0 || header().tableEntries != table.size()) return false;
+        table.copyIn(0, table.size(), reinterpret_cast<const uint64_t *>(base + header().tableOffset));
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include "solver.h"
+
+using namespace std;
+
+// Solves a small m,n,k board exactly and writes its perfect-play table to
+// solved_<rows>x<cols>k<k>.tts, which the bot maps into memory when it plays
+// on that board. The 3x3 table is built into the engine and needs no file.
+// Usage: solver <rows> <cols> <k>
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        cout << "Usage: solver <rows> <cols> <k>" << endl;
+        return 1;
+    }
+    int rows = stoi(argv[1]), cols = stoi(argv[2]), k = stoi(argv[3]);
+    if (rows < 1 || cols < 1 || rows * cols > MAX_SOLVED_CELLS || k < 1) {
+        cout << "Boards up to " << MAX_SOLVED_CELLS << " cells can be solved" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t positions = powerOf3(rows * cols);
+    vector<uint8_t> scores(positions), moves(positions), table(positions);
+    solveBoard(rows, cols, k, scores.data(), moves.data(), table.data());
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long long counts[4] = {0, 0, 0, 0};
+    for (uint8_t entry : table) counts[solvedResult(entry)]++;
+    const char *names[4] = {"", "loss", "draw", "win"};
+    cout << rows << "x" << cols << " k=" << k << ": " << names[solvedResult(table[0])] << " for the first player, "
+         << counts[1] + counts[2] + counts[3] << " positions (" << counts[3] << " won, " << counts[2] << " drawn, "
+         << counts[1] << " lost for the player to move) in " << seconds << " s" << endl;
+
+    string path = SolvedTable::fileName(rows, cols, k);
+    FILE *file = fopen(path.c_str(), "wb");
+    SolvedFileHeader header = {SOLVED_FILE_MAGIC, rows, cols, k};
+    bool ok = file && fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(table.data(), 1, positions, file) == positions;
+    if (file && fclose(file) != 0) ok = false;
+    if (!ok) {
+        cout << "Could not write " << path << endl;
+        return 1;
+    }
+    cout << "Wrote " << path << endl;
+    return 0;
+}
@@ -0,0 +1,291 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+// Perfect-play tables for small m,n,k boards (at most 16 cells).
+//
+// A position is numbered in base 3, cell i (row-major) contributing
+// 0 (empty), 1 ('O') or 2 ('X') times 3^i, and the table holds one entry
+// byte per number: the result for the player to move and the best move.
+// 'O' always moves first, so the player to move follows from the stone
+// counts; positions that cannot come up in a game have no entry.
+//
+// The solver is a negamax over the whole game tree that remembers each
+// position under the smallest number of its symmetric images (8 on a square
+// board, 4 on a rectangle), so mirrored positions are solved once. It
+// prefers the fastest win and the slowest loss. Everything is constexpr:
+// the 3x3 table is built by the compiler, larger ones by the solver tool
+// (solver.cpp) into files that SolvedTable maps into memory.
+
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "symmetry.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+constexpr int MAX_SOLVED_CELLS = 16;
+
+// Entry byte: result in bits 0-1, best move + 1 in bits 2-6 (0 when there is none)
+enum SolvedResult {
+    SOLVED_NONE, // Not a position of a game
+    SOLVED_LOSS,
+    SOLVED_DRAW,
+    SOLVED_WIN
+};
+
+constexpr uint8_t makeSolvedEntry(int result, int move) { return (uint8_t)(result | (move + 1) << 2); }
+constexpr int solvedResult(uint8_t entry) { return entry & 3; }
+constexpr int solvedMove(uint8_t entry) { return (entry >> 2) - 1; }
+
+constexpr uint32_t powerOf3(int n) {
+    uint32_t p = 1;
+    for (int i = 0; i < n; ++i) p *= 3;
+    return p;
+}
+
+// Board being solved: its shape, the stones as 0, 1 or 2 per cell, and the
+// position number of each symmetric image, kept up to date by place()
+struct SolverBoard {
+    int rows, cols, winLength;
+    int cellCount, symmetries;
+    uint8_t cells[MAX_SOLVED_CELLS];
+    uint32_t imageWeight[MAX_SYMMETRIES][MAX_SOLVED_CELLS]; // 3^transformCell(t, i)
+    uint32_t images[MAX_SYMMETRIES];
+
+    constexpr void place(int index, int stone) {
+        int change = stone - cells[index];
+        cells[index] = (uint8_t)stone;
+        for (int t = 0; t < symmetries; ++t) images[t] += change * imageWeight[t][index];
+    }
+
+    // Smallest position number among the images, and the symmetry giving it
+    constexpr uint32_t canonicalCode(int &symmetry) const {
+        symmetry = 0;
+        for (int t = 1; t < symmetries; ++t) {
+            if (images[t] < images[symmetry]) symmetry = t;
+        }
+        return images[symmetry];
+    }
+};
+
+// Whether the stone on index makes winLength in a row
+constexpr bool solverWins(const SolverBoard &board, int index) {
+    const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    int row = index / board.cols, col = index % board.cols;
+    uint8_t stone = board.cells[index];
+    for (const auto &dir : directions) {
+        int count = 1;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int r = row + sign * dir[0], c = col + sign * dir[1];
+            while (r >= 0 && r < board.rows && c >= 0 && c < board.cols && board.cells[r * board.cols + c] == stone) {
+                count++;
+                r += sign * dir[0];
+                c += sign * dir[1];
+            }
+        }
+        if (count >= board.winLength) return true;
+    }
+    return false;
+}
+
+// Negamax score for the player to move (side 1 or 2): empty cells left + 1
+// for a win, negative for a loss, 0 for a draw. scores and moves are indexed
+// by canonical position number; scores holds score + 64, 0 when unsolved,
+// and moves the best move in the canonical orientation.
+constexpr int solvePosition(SolverBoard &board, int side, int empty, int lastMove, uint8_t *scores, uint8_t *moves) {
+    if (lastMove >= 0 && solverWins(board, lastMove)) return -(empty + 1);
+    if (empty == 0) return 0;
+
+    int symmetry = 0;
+    uint32_t canonical = board.canonicalCode(symmetry);
+    if (scores[canonical]) return scores[canonical] - 64;
+
+    int bestScore = -64, bestMove = -1;
+    for (int i = 0; i < board.cellCount; ++i) {
+        if (board.cells[i]) continue;
+        board.place(i, side);
+        int score = -solvePosition(board, 3 - side, empty - 1, i, scores, moves);
+        board.place(i, 0);
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = i;
+        }
+    }
+    scores[canonical] = (uint8_t)(bestScore + 64);
+    moves[canonical] = (uint8_t)transformCell(board.rows, board.cols, symmetry, bestMove);
+    return bestScore;
+}
+
+// Write the entry of every position reachable from the current one, numbered code, into table
+constexpr void fillSolvedTable(SolverBoard &board, uint32_t code, int side, int empty, int lastMove,
+                               const uint8_t *scores, const uint8_t *moves, uint8_t *table) {
+    if (table[code]) return; // Reached before by another move order
+    if (lastMove >= 0 && solverWins(board, lastMove)) {
+        table[code] = makeSolvedEntry(SOLVED_LOSS, -1);
+        return;
+    }
+    if (empty == 0) {
+        table[code] = makeSolvedEntry(SOLVED_DRAW, -1);
+        return;
+    }
+
+    // Map the canonical best move back to this orientation
+    int symmetry = 0;
+    uint32_t canonical = board.canonicalCode(symmetry);
+    int score = scores[canonical] - 64;
+    int move = transformCell(board.rows, board.cols, inverseSymmetry(board.rows, board.cols, symmetry), moves[canonical]);
+    table[code] = makeSolvedEntry(score > 0 ? SOLVED_WIN : score < 0 ? SOLVED_LOSS : SOLVED_DRAW, move);
+
+    for (int i = 0; i < board.cellCount; ++i) {
+        if (board.cells[i]) continue;
+        board.place(i, side);
+        fillSolvedTable(board, board.images[0], 3 - side, empty - 1, i, scores, moves, table);
+        board.place(i, 0);
+    }
+}
+
+// Solve a rows x cols board with win length k into table, with scratch
+// arrays scores and moves; all three hold powerOf3(rows * cols) bytes, zeroed
+constexpr void solveBoard(int rows, int cols, int k, uint8_t *scores, uint8_t *moves, uint8_t *table) {
+    SolverBoard board = {rows, cols, k, rows * cols, symmetryCount(rows, cols), {}, {}, {}};
+    for (int t = 0; t < board.symmetries; ++t) {
+        for (int i = 0; i < board.cellCount; ++i) board.imageWeight[t][i] = powerOf3(transformCell(rows, cols, t, i));
+    }
+    solvePosition(board, 1, board.cellCount, -1, scores, moves);
+    fillSolvedTable(board, 0, 1, board.cellCount, -1, scores, moves, table);
+}
+
+template <int R, int C, int K>
+constexpr std::array<uint8_t, powerOf3(R * C)> makeSolvedTable() {
+    std::array<uint8_t, powerOf3(R * C)> scores = {}, moves = {}, table = {};
+    solveBoard(R, C, K, scores.data(), moves.data(), table.data());
+    return table;
+}
+
+// Classic tic-tac-toe, solved by the compiler
+inline constexpr std::array<uint8_t, powerOf3(9)> SOLVED_3X3 = makeSolvedTable<3, 3, 3>();
+
+// File written by the solver tool: this header, then powerOf3(rows * cols) entry bytes
+struct SolvedFileHeader {
+    uint32_t magic;
+    int32_t rows, cols, winLength;
+};
+
+const uint32_t SOLVED_FILE_MAGIC = 0x56535454; // "TTSV"
+
+// Perfect-play table of one board: the built-in 3x3 one or a table file
+class SolvedTable {
+private:
+    int rows, cols, winLength;
+    const uint8_t *entries;
+    std::vector<uint8_t> storage; // File contents where mmap is not available
+    const void *mapping;
+    size_t mappingSize;
+
+    SolvedTable(int r, int c, int k, const uint8_t *e) : rows(r), cols(c), winLength(k), entries(e), mapping(nullptr), mappingSize(0) {}
+
+    // Load solved_<rows>x<cols>k<k>.tts from the working directory
+    static SolvedTable *load(int r, int c, int k) {
+        std::string path = fileName(r, c, k);
+        size_t size = sizeof(SolvedFileHeader) + powerOf3(r * c);
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat info;
+        void *map = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size == size) map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) return nullptr;
+        const SolvedFileHeader *header = static_cast<const SolvedFileHeader *>(map);
+        if (header->magic != SOLVED_FILE_MAGIC || header->rows != r || header->cols != c || header->winLength != k) {
+            munmap(map, size);
+            return nullptr;
+        }
+        SolvedTable *table = new SolvedTable(r, c, k, static_cast<const uint8_t *>(map) + sizeof(SolvedFileHeader));
+        table->mapping = map;
+        table->mappingSize = size;
+        return table;
+#else
+        FILE *file = fopen(path.c_str(), "rb");
+        if (!file) return nullptr;
+        SolvedFileHeader header = {};
+        std::vector<uint8_t> data(size - sizeof(header));
+        bool ok = fread(&header, sizeof(header), 1, file) == 1 && fread(data.data(), 1, data.size(), file) == data.size();
+        fclose(file);
+        if (!ok || header.magic != SOLVED_FILE_MAGIC || header.rows != r || header.cols != c || header.winLength != k) return nullptr;
+        SolvedTable *table = new SolvedTable(r, c, k, nullptr);
+        table->storage.swap(data);
+        table->entries = table->storage.data();
+        return table;
+#endif
+    }
+
+public:
+    ~SolvedTable() {
+#ifndef _WIN32
+        if (mapping) munmap(const_cast<void *>(mapping), mappingSize);
+#endif
+    }
+
+    SolvedTable(const SolvedTable &) = delete;
+    SolvedTable &operator=(const SolvedTable &) = delete;
+
+    static std::string fileName(int r, int c, int k) {
+        return "solved_" + std::to_string(r) + "x" + std::to_string(c) + "k" + std::to_string(k) + ".tts";
+    }
+
+    // Table for a board, or nullptr if it is too big or no table file was
+    // found. Files are looked for once per board and kept for the process.
+    static const SolvedTable *find(int r, int c, int k) {
+        if (r * c > MAX_SOLVED_CELLS) return nullptr;
+        static std::mutex lock;
+        static std::vector<std::unique_ptr<SolvedTable>> tables;
+        static std::vector<int> missing; // Boards without a file, as (r * 64 + c) * 64 + k
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto &table : tables) {
+            if (table->rows == r && table->cols == c && table->winLength == k) return table.get();
+        }
+        int board = (r * 64 + c) * 64 + k;
+        for (int m : missing) {
+            if (m == board) return nullptr;
+        }
+
+        SolvedTable *table = (r == 3 && c == 3 && k == 3) ? new SolvedTable(3, 3, 3, SOLVED_3X3.data()) : load(r, c, k);
+        if (!table) {
+            missing.push_back(board);
+            return nullptr;
+        }
+        tables.emplace_back(table);
+        return table;
+    }
+
+    // Entry of a position given as row-major cells of ' ', 'O' and 'X'
+    uint8_t lookup(const char *cells) const {
+        uint32_t code = 0, power = 1;
+        for (int i = 0; i < rows * cols; ++i, power *= 3) {
+            code += (cells[i] == 'O' ? 1 : cells[i] == 'X' ? 2 : 0) * power;
+        }
+        return entries[code];
+    }
+
+    // Best move for side as a cell index, if side is the one to move in this position
+    bool bestMove(const char *cells, char side, int &index) const {
+        int stones[2] = {0, 0};
+        for (int i = 0; i < rows * cols; ++i) {
+            if (cells[i] != ' ') stones[cells[i] == 'X']++;
+        }
+        if (side != (stones[0] == stones[1] ? 'O' : 'X')) return false;
+        index = solvedMove(lookup(cells));
+        return index >= 0;
+    }
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+// Symmetries of a rows x cols board, as maps from a cell to the cell it
+// lands on. A square board has 8 (the rotations and reflections); any other
+// rectangle has the 4 that keep its shape: the identity, the half turn and
+// the two mirrors. Symmetry 0 is always the identity.
+
+constexpr int MAX_SYMMETRIES = 8;
+
+constexpr int symmetryCount(int rows, int cols) { return rows == cols ? 8 : 4; }
+
+// Flat index of the cell (row, col) lands on under symmetry t
+constexpr int transformRowCol(int rows, int cols, int t, int row, int col) {
+    int lastRow = rows - 1, lastCol = cols - 1;
+    if (rows != cols) t = (t == 1) ? 2 : (t == 2) ? 4 : (t == 3) ? 5 : 0;
+    switch (t) {
+    case 1: return col * cols + (lastRow - row);             // Quarter turn
+    case 2: return (lastRow - row) * cols + (lastCol - col); // Half turn
+    case 3: return (lastCol - col) * cols + row;             // Three quarter turn
+    case 4: return row * cols + (lastCol - col);             // Mirror left-right
+    case 5: return (lastRow - row) * cols + col;             // Mirror top-bottom
+    case 6: return col * cols + row;                         // Main diagonal
+    case 7: return (lastCol - col) * cols + (lastRow - row); // Anti-diagonal
+    default: return row * cols + col;
+    }
+}
+
+constexpr int transformCell(int rows, int cols, int t, int index) {
+    return transformRowCol(rows, cols, t, index / cols, index % cols);
+}
+
+// The symmetry that undoes t: the quarter turns undo each other, every
+// other symmetry is its own inverse
+constexpr int inverseSymmetry(int rows, int cols, int t) {
+    if (rows != cols) return t;
+    return (t == 1) ? 3 : (t == 3) ? 1 : t;
+}
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef TIMECONTROL_H
+#define TIMECONTROL_H
+
+// Game clocks on std::chrono::steady_clock, kept in milliseconds.
+//
+// TimeControl describes the rules, GameClock runs them for both sides:
+// - per move: every move has the same limit, nothing carries over
+// - sudden death: each side has one budget for the whole game
+// - Fischer: a budget, plus an increment added after every move
+// - byo-yomi: a main time, then a number of periods; a move made within a
+//   period keeps it, and each period that runs out is lost
+// A side whose time (and last period) runs out has lost on time.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+
+enum TimeMode {
+    TIME_PER_MOVE,
+    TIME_SUDDEN_DEATH,
+    TIME_FISCHER,
+    TIME_BYOYOMI
+};
+
+struct TimeControl {
+    TimeMode mode;
+    long long mainMs;      // Per move: the limit; otherwise each side's main time
+    long long incrementMs; // Fischer: added after each move
+    long long periodMs;    // Byo-yomi: length of one period
+    int periods;           // Byo-yomi: periods after the main time
+
+    static TimeControl perMove(long long ms) { return {TIME_PER_MOVE, ms, 0, 0, 0}; }
+    static TimeControl suddenDeath(long long ms) { return {TIME_SUDDEN_DEATH, ms, 0, 0, 0}; }
+    static TimeControl fischer(long long ms, long long increment) { return {TIME_FISCHER, ms, increment, 0, 0}; }
+    static TimeControl byoyomi(long long ms, int count, long long period) { return {TIME_BYOYOMI, ms, 0, period, count}; }
+
+    // Short description, e.g. "30s per move", "3 min + 2s" or "1 min + 3x10s"
+    std::string describe() const {
+        auto seconds = [](long long ms) {
+            return ms % 60000 == 0 && ms > 0 ? std::to_string(ms / 60000) + " min" : std::to_string(ms / 1000) + "s";
+        };
+        switch (mode) {
+        case TIME_PER_MOVE: return seconds(mainMs) + " per move";
+        case TIME_SUDDEN_DEATH: return seconds(mainMs);
+        case TIME_FISCHER: return seconds(mainMs) + " + " + seconds(incrementMs);
+        default: return seconds(mainMs) + " + " + std::to_string(periods) + "x" + seconds(periodMs);
+        }
+    }
+};
+
+// A clock's rules and both sides' time in fixed-size fields, for saving a
+// game that is being played (see snapshot.h). The time spent on the running
+// turn is kept, so a restored clock goes on from where it stopped.
+struct ClockState {
+    int32_t mode;          // TimeMode of the control
+    int32_t periods;       // Byo-yomi periods of the control
+    int64_t mainMs, incrementMs, periodMs;
+    int64_t sideMainMs[2]; // Main time of 'O' and 'X' at the start of their turn
+    int32_t sidePeriods[2];
+    int32_t running;       // Side being timed, 0 for 'O' and 1 for 'X', -1 when stopped
+    int32_t reserved;
+    int64_t turnMs;        // Spent on the running turn
+};
+
+class GameClock {
+public:
+    // Time of one side at some instant
+    struct Reading {
+        long long mainMs;   // Main time left
+        int periods;        // Byo-yomi periods left, the current one included
+        long long periodMs; // Time left in the current period
+        bool flagged;       // Out of time
+    };
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    TimeControl control;
+    long long mainMs[2]; // Main time of 'O' and 'X' at the start of their turn
+    int periods[2];
+    int running;         // Side whose turn is being timed, -1 when stopped
+    Clock::time_point turnStart;
+
+    static int sideOf(char symbol) { return symbol == 'X' ? 1 : 0; }
+
+    long long elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - turnStart).count();
+    }
+
+    // Side's time after spending spent milliseconds of it on the current turn
+    Reading readAfter(int side, long long spent) const {
+        Reading r = {mainMs[side] - spent, periods[side], control.periodMs, false};
+        if (r.mainMs >= 0) return r;
+        long long over = -r.mainMs; // Into the periods
+        r.mainMs = 0;
+        if (control.mode != TIME_BYOYOMI || control.periodMs <= 0) {
+            r.flagged = true;
+            return r;
+        }
+        r.periods -= (int)(over / control.periodMs);
+        r.periodMs = control.periodMs - over % control.periodMs;
+        r.flagged = r.periods <= 0;
+        if (r.flagged) r.periods = 0;
+        return r;
+    }
+
+public:
+    static const long long SAFETY_MS = 50; // Kept back from a move budget for the move to reach the clock
+    static const int MOVES_TO_GO = 30;     // Moves a game budget is spread over
+
+    explicit GameClock(const TimeControl &tc = TimeControl::perMove(30000)) : control(tc), running(-1) {
+        reset();
+    }
+
+    const TimeControl &getControl() const { return control; }
+    bool isRunning() const { return running >= 0; }
+
+    ClockState saveState() const {
+        return {(int32_t)control.mode, (int32_t)control.periods, control.mainMs, control.incrementMs, control.periodMs,
+                {mainMs[0], mainMs[1]}, {periods[0], periods[1]}, (int32_t)running, 0, running >= 0 ? elapsedMs() : 0};
+    }
+
+    // Whether a state read from a file can be restored: a known mode, no
+    // negative times and a side or none running
+    static bool isValidState(const ClockState &s) {
+        return s.mode >= TIME_PER_MOVE && s.mode <= TIME_BYOYOMI && s.periods >= 0 && s.mainMs >= 0 && s.incrementMs >= 0 &&
+               s.periodMs >= 0 && s.sideMainMs[0] >= 0 && s.sideMainMs[1] >= 0 && s.sidePeriods[0] >= 0 &&
+               s.sidePeriods[1] >= 0 && s.running >= -1 && s.running <= 1 && s.turnMs >= 0;
+    }
+
+    // Take over a saved state; a running turn goes on with its saved time
+    // spent, and the time between saving and now is not charged
+    void restoreState(const ClockState &s) {
+        control = {(TimeMode)s.mode, s.mainMs, s.incrementMs, s.periodMs, s.periods};
+        for (int side = 0; side < 2; ++side) {
+            mainMs[side] = s.sideMainMs[side];
+            periods[side] = s.sidePeriods[side];
+        }
+        running = s.running;
+        turnStart = Clock::now() - std::chrono::milliseconds(s.turnMs);
+    }
+
+    void reset() {
+        for (int side = 0; side < 2; ++side) {
+            mainMs[side] = control.mainMs;
+            periods[side] = control.periods;
+        }
+        running = -1;
+    }
+
+    // Start timing the turn of symbol
+    void start(char symbol) {
+        running = sideOf(symbol);
+        turnStart = Clock::now();
+    }
+
+    // End the running turn: charge its time and apply the increment, the
+    // byo-yomi period reset or the per-move reset. Returns false if the side
+    // ran out of time during the turn.
+    bool endTurn() {
+        if (running < 0) return true;
+        Reading r = readAfter(running, elapsedMs());
+        int side = running;
+        running = -1;
+        if (r.flagged) {
+            mainMs[side] = 0;
+            periods[side] = 0;
+            return false;
+        }
+        switch (control.mode) {
+        case TIME_PER_MOVE: mainMs[side] = control.mainMs; break;
+        case TIME_FISCHER: mainMs[side] = r.mainMs + control.incrementMs; break;
+        default:
+            mainMs[side] = r.mainMs;
+            periods[side] = r.periods;
+        }
+        return true;
+    }
+
+    Reading read(char symbol) const {
+        int side = sideOf(symbol);
+        return readAfter(side, side == running ? elapsedMs() : 0);
+    }
+
+    // Milliseconds symbol can still use on this turn before losing on time
+    long long remainingMs(char symbol) const {
+        Reading r = read(symbol);
+        if (r.flagged) return 0;
+        if (control.mode != TIME_BYOYOMI) return r.mainMs;
+        return r.mainMs + r.periodMs; // Periods after the current one do not carry over
+    }
+
+    bool flagged(char symbol) const { return read(symbol).flagged; }
+
+    // Time a bot playing symbol should spend on this move: the whole limit
+    // per move, otherwise a share of its main time plus what comes back (the
+    // increment, or a byo-yomi period), always short of what it has left
+    long long moveBudgetMs(char symbol) const {
+        Reading r = read(symbol);
+        long long budget;
+        switch (control.mode) {
+        case TIME_PER_MOVE: budget = r.mainMs; break;
+        case TIME_SUDDEN_DEATH: budget = r.mainMs / MOVES_TO_GO; break;
+        case TIME_FISCHER: budget = r.mainMs / MOVES_TO_GO + control.incrementMs * 3 / 4; break;
+        default: budget = r.mainMs / MOVES_TO_GO + (r.periods > 0 ? r.periodMs : 0);
+        }
+        return std::max(1LL, std::min(budget, remainingMs(symbol) - SAFETY_MS));
+    }
+
+    // Time left as shown to players: "29.3s", "4:58.1", or "7.4s (3x10s)" in a byo-yomi period
+    std::string format(char symbol) const {
+        Reading r = read(symbol);
+        bool overtime = control.mode == TIME_BYOYOMI && r.mainMs == 0 && !r.flagged;
+        long long ms = overtime ? r.periodMs : r.mainMs;
+        long long tenths = ms / 100;
+        std::string text;
+        if (ms >= 60000) {
+            long long secs = tenths / 10 % 60;
+            text = std::to_string(tenths / 600) + ":" + (secs < 10 ? "0" : "") + std::to_string(secs) + "." + std::to_string(tenths % 10);
+        } else {
+            text = std::to_string(tenths / 10) + "." + std::to_string(tenths % 10) + "s";
+        }
+        if (overtime) text += " (" + std::to_string(r.periods) + "x" + std::to_string(control.periodMs / 1000) + "s)";
+        return text;
+    }
+};
+
+#endif
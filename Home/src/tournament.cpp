@@ -0,0 +1,533 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include "engine.h"
+
+using namespace std;
+
+// Plays two engine configurations against each other to tell whether a
+// change keeps its playing strength. Games run on several threads in pairs:
+// both games of a pair start from the same random opening, with colours
+// swapped. The result is engine 1's score with an Elo estimate and its 95%
+// error bars, and a sequential probability ratio test (SPRT) of Elo elo0
+// against elo1 stops the match as soon as either is accepted.
+// Exits with 1 when H0 (engine 1 is at most elo0 stronger) is accepted.
+//
+// Engines:
+//   bot[:depth=N,time=MS,pruning=all|none|lmr,null,futility,weights=file,level=NAME,seed=N]
+//                the game's BotManager (finalProject.cpp); level is one of
+//                BOT_LEVELS (easy to expert), seed that of its evaluation noise
+//   sapfinal     the dynamic-depth minimax bot of sapfinal.cpp, always for five in a row
+//
+// Usage: tournament [--engine1 SPEC] [--engine2 SPEC] [--games N] [--threads N]
+//                   [--rows N] [--cols N] [--win K] [--opening N] [--seed N]
+//                   [--elo0 E] [--elo1 E] [--alpha A] [--beta B] [--no-sprt]
+
+struct EngineSpec {
+    string name; // As given on the command line
+    bool sapfinal = false;
+    int depth = 0; // 0 for the bot's default
+    long long timeMs = 0;
+    unsigned pruning = BotManager::PRUNE_ALL;
+    EvalWeights weights = EvalWeights::defaults();
+    int level = -1; // Index in BOT_LEVELS, -1 for none
+    uint64_t seed = 1;
+};
+
+struct TournamentOptions {
+    EngineSpec engines[2];
+    int games = 200;
+    int threads = max(1u, thread::hardware_concurrency());
+    int rows = 15, cols = 15, winLength = DEFAULT_WIN_LENGTH;
+    int openingMoves = 4;
+    unsigned seed = 1;
+    bool sprt = true;
+    double elo0 = 0, elo1 = 10;
+    double alpha = 0.05, beta = 0.05;
+};
+
+// One side of a game, playing on the grid shared with the other side
+class Engine {
+public:
+    virtual ~Engine() {}
+
+    // Play the side's move with Grid::makeMove; false if there is none
+    virtual bool makeMove(int &row, int &col) = 0;
+    virtual long long getLastNodes() const = 0;
+};
+
+class BotEngine : public Engine {
+private:
+    BotManager bot;
+
+public:
+    BotEngine(Grid &grid, char symbol, const EngineSpec &spec) : bot(grid, symbol, spec.weights) {
+        if (spec.level >= 0) bot.setLevel(spec.level, spec.seed);
+        if (spec.depth > 0) bot.setSearchDepth(spec.depth);
+        bot.setTimeLimit(spec.timeMs);
+        bot.setPruning(spec.pruning);
+        bot.setVerbose(false);
+    }
+
+    bool makeMove(int &row, int &col) override {
+        bot.makeMove();
+        row = bot.getLastRow();
+        col = bot.getLastCol();
+        return row != -1;
+    }
+
+    long long getLastNodes() const override { return bot.getLastNodes(); }
+};
+
+// The bot of sapfinal.cpp on the engine's Grid: minimax with alpha-beta over
+// the empty neighbours of stones, 2 to 4 plies deep by the number of empty
+// cells. Candidates are taken once each (sapfinal lists a cell once per
+// neighbouring stone), which leaves the chosen move unchanged.
+class SapfinalEngine : public Engine {
+private:
+    Grid &grid;
+    char botSymbol;
+    char opponentSymbol;
+    long long nodes;
+
+    int getDynamicDepth() {
+        int emptyCells = grid.countEmptyCells();
+        if (emptyCells > 70) return 2;
+        if (emptyCells > 50) return 3;
+        return 4;
+    }
+
+    int evaluateGrid() {
+        nodes++;
+        int score = 0;
+        for (int r = 0; r < grid.getRows(); ++r) {
+            for (int c = 0; c < grid.getCols(); ++c) {
+                if (grid.getCell(r, c) == botSymbol) {
+                    score += evaluatePosition(r, c, botSymbol);
+                } else if (grid.getCell(r, c) == opponentSymbol) {
+                    score -= evaluatePosition(r, c, opponentSymbol) * 2;
+                }
+            }
+        }
+        return score;
+    }
+
+    int evaluatePosition(int row, int col, char symbol) {
+        int score = 0;
+        int centerRow = grid.getRows() / 2;
+        int centerCol = grid.getCols() / 2;
+        score += 50 - abs(centerRow - row) - abs(centerCol - col);
+        score += countConsecutive(row, col, 0, 1, symbol);
+        score += countConsecutive(row, col, 1, 0, symbol);
+        score += countConsecutive(row, col, 1, 1, symbol);
+        score += countConsecutive(row, col, -1, 1, symbol);
+        return score;
+    }
+
+    int countConsecutive(int row, int col, int rowDir, int colDir, char symbol) {
+        int count = 0, openEnds = 0;
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            for (int i = 1; i < 5; ++i) {
+                int newRow = row + sign * i * rowDir;
+                int newCol = col + sign * i * colDir;
+                if (newRow < 0 || newRow >= grid.getRows() || newCol < 0 || newCol >= grid.getCols()) continue;
+                if (grid.getCell(newRow, newCol) == symbol) {
+                    count++;
+                } else {
+                    if (grid.isCellEmpty(newRow, newCol)) openEnds++;
+                    break;
+                }
+            }
+        }
+        if (count >= 4) return (symbol == botSymbol ? 1100 : -1000);
+        if (count == 3 && openEnds == 2) return (symbol == botSymbol ? 700 : -900);
+        if (count == 3 && openEnds == 1) return (symbol == botSymbol ? 500 : -600);
+        if (count == 2 && openEnds == 2) return (symbol == botSymbol ? 200 : -200);
+        if (count == 2 && openEnds == 1) return (symbol == botSymbol ? 100 : -100);
+        return 0;
+    }
+
+    int minimax(int depth, bool isMaximizing, int alpha, int beta) {
+        if (grid.isFull() || depth == 0) return evaluateGrid();
+        char symbol = isMaximizing ? botSymbol : opponentSymbol;
+        int bestScore = isMaximizing ? numeric_limits<int>::min() : numeric_limits<int>::max();
+        for (const auto &move : getCandidateMoves()) {
+            grid.setCell(move.first, move.second, symbol);
+            int score = minimax(depth - 1, !isMaximizing, alpha, beta);
+            grid.setCell(move.first, move.second, ' ');
+            if (isMaximizing) {
+                bestScore = max(bestScore, score);
+                alpha = max(alpha, bestScore);
+            } else {
+                bestScore = min(bestScore, score);
+                beta = min(beta, bestScore);
+            }
+            if (beta <= alpha) break;
+        }
+        return bestScore;
+    }
+
+    // Empty neighbours of stones, in the order sapfinal first finds them
+    vector<pair<int, int>> getCandidateMoves() {
+        int rows = grid.getRows(), cols = grid.getCols();
+        vector<pair<int, int>> candidates;
+        vector<char> seen((size_t)rows * cols, 0);
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                if (grid.isCellEmpty(r, c)) continue;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        int newRow = r + dr, newCol = c + dc;
+                        if (newRow < 0 || newRow >= rows || newCol < 0 || newCol >= cols) continue;
+                        if (!grid.isCellEmpty(newRow, newCol) || seen[newRow * cols + newCol]) continue;
+                        seen[newRow * cols + newCol] = 1;
+                        candidates.emplace_back(newRow, newCol);
+                    }
+                }
+            }
+        }
+        return candidates;
+    }
+
+public:
+    SapfinalEngine(Grid &g, char symbol)
+        : grid(g), botSymbol(symbol), opponentSymbol(symbol == 'O' ? 'X' : 'O'), nodes(0) {}
+
+    bool makeMove(int &row, int &col) override {
+        nodes = 0;
+        int depth = getDynamicDepth();
+        int bestScore = numeric_limits<int>::min();
+        row = col = -1;
+        for (const auto &move : getCandidateMoves()) {
+            grid.setCell(move.first, move.second, botSymbol);
+            int score = minimax(depth - 1, false, numeric_limits<int>::min(), numeric_limits<int>::max());
+            grid.setCell(move.first, move.second, ' ');
+            if (score > bestScore) {
+                bestScore = score;
+                row = move.first;
+                col = move.second;
+            }
+        }
+        if (row == -1) return false;
+        grid.makeMove(row, col, botSymbol);
+        return true;
+    }
+
+    long long getLastNodes() const override { return nodes; }
+};
+
+unique_ptr<Engine> createEngine(const EngineSpec &spec, Grid &grid, char symbol) {
+    if (spec.sapfinal) return unique_ptr<Engine>(new SapfinalEngine(grid, symbol));
+    return unique_ptr<Engine>(new BotEngine(grid, symbol, spec));
+}
+
+// "bot", "bot:depth=3,time=100", "bot:level=easy", "sapfinal"; false with a message if the spec is wrong
+bool parseEngine(const string &text, EngineSpec &spec) {
+    spec = EngineSpec();
+    spec.name = text;
+    size_t colon = text.find(':');
+    string kind = text.substr(0, colon);
+    if (kind == "sapfinal") {
+        spec.sapfinal = true;
+        return colon == string::npos;
+    }
+    if (kind != "bot") {
+        cout << "Unknown engine " << kind << endl;
+        return false;
+    }
+    if (colon == string::npos) return true;
+
+    // Options are separated by commas; pruning flags are too, so a part
+    // without '=' continues the previous option
+    string key;
+    string rest = text.substr(colon + 1) + ",";
+    for (size_t start = 0, comma; (comma = rest.find(',', start)) != string::npos; start = comma + 1) {
+        string part = rest.substr(start, comma - start);
+        size_t equals = part.find('=');
+        string value = part;
+        if (equals != string::npos) {
+            key = part.substr(0, equals);
+            value = part.substr(equals + 1);
+        }
+        if (key == "depth") spec.depth = stoi(value);
+        else if (key == "time") spec.timeMs = stoll(value);
+        else if (key == "seed") spec.seed = stoull(value);
+        else if (key == "level") {
+            for (int level = 0; level < BOT_LEVEL_COUNT; ++level) {
+                string name = BOT_LEVELS[level].name;
+                if (equal(name.begin(), name.end(), value.begin(), value.end(),
+                          [](char a, char b) { return tolower((unsigned char)a) == tolower((unsigned char)b); })) {
+                    spec.level = level;
+                }
+            }
+            if (spec.level < 0) {
+                cout << "Unknown level " << value << endl;
+                return false;
+            }
+        }
+        else if (key == "pruning") {
+            if (equals != string::npos) spec.pruning = BotManager::PRUNE_NONE;
+            if (value == "all") spec.pruning = BotManager::PRUNE_ALL;
+            if (value == "lmr") spec.pruning |= BotManager::PRUNE_LMR;
+            if (value == "null") spec.pruning |= BotManager::PRUNE_NULL_MOVE;
+            if (value == "futility") spec.pruning |= BotManager::PRUNE_FUTILITY;
+        } else if (key == "weights") {
+            if (!spec.weights.load(value)) {
+                cout << "Could not load weights from " << value << endl;
+                return false;
+            }
+        } else {
+            cout << "Unknown engine option " << key << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Time and nodes spent by one engine
+struct EngineStats {
+    long long moves = 0;
+    long long nodes = 0;
+    double seconds = 0;
+};
+
+// Random stones around the center, alternating O and X, without k in a row
+vector<pair<int, int>> makeOpening(const TournamentOptions &opt, unsigned seed) {
+    Grid grid(opt.rows, opt.cols, opt.winLength);
+    GameLogic gameLogic(grid);
+    mt19937 rng(seed);
+    uniform_int_distribution<int> offset(-3, 3);
+    vector<pair<int, int>> moves;
+    char player = 'O';
+    while ((int)moves.size() < opt.openingMoves) {
+        int row = max(0, min(opt.rows - 1, opt.rows / 2 + offset(rng)));
+        int col = max(0, min(opt.cols - 1, opt.cols / 2 + offset(rng)));
+        if (!grid.isCellEmpty(row, col)) continue;
+        grid.makeMove(row, col, player);
+        if (gameLogic.checkWinner(row, col).hasWinner) {
+            grid.unmakeMove();
+            continue;
+        }
+        moves.emplace_back(row, col);
+        player = (player == 'O') ? 'X' : 'O';
+    }
+    return moves;
+}
+
+// Play one game from the opening; returns 'O', 'X' or 'D'. A side that
+// finds no move on a board that is not full loses.
+char playGame(const TournamentOptions &opt, const vector<pair<int, int>> &opening, int engineO, EngineStats *stats) {
+    Grid grid(opt.rows, opt.cols, opt.winLength);
+    GameLogic gameLogic(grid);
+    PlayerManager playerManager;
+    for (const auto &move : opening) {
+        grid.makeMove(move.first, move.second, playerManager.getCurrentPlayer());
+        playerManager.switchPlayer();
+    }
+
+    unique_ptr<Engine> sides[2] = {createEngine(opt.engines[engineO], grid, 'O'), createEngine(opt.engines[1 - engineO], grid, 'X')};
+    while (!grid.isFull()) {
+        char player = playerManager.getCurrentPlayer();
+        int side = (player == 'O') ? 0 : 1;
+        EngineStats &s = stats[side == 0 ? engineO : 1 - engineO];
+
+        int row, col;
+        auto start = chrono::steady_clock::now();
+        bool found = sides[side]->makeMove(row, col);
+        s.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        s.nodes += sides[side]->getLastNodes();
+        s.moves++;
+        if (!found) return player == 'O' ? 'X' : 'O';
+
+        if (gameLogic.checkWinner(row, col).hasWinner) return player;
+        playerManager.switchPlayer();
+    }
+    return 'D';
+}
+
+// Results from engine 1's side
+struct Tally {
+    long long wins = 0, draws = 0, losses = 0;
+    long long pairs[5] = {0, 0, 0, 0, 0}; // Pairs by engine 1's points over both games, in half points
+    EngineStats stats[2];
+
+    long long pairCount() const { return pairs[0] + pairs[1] + pairs[2] + pairs[3] + pairs[4]; }
+
+    // Mean and variance of a pair's score, as a fraction of its two games,
+    // with prior pairs added to every count
+    void pairScore(double &mean, double &variance, double prior = 0) const {
+        double n = 0;
+        mean = variance = 0;
+        for (int k = 0; k < 5; ++k) {
+            n += pairs[k] + prior;
+            mean += (pairs[k] + prior) * (k / 4.0);
+        }
+        if (n == 0) return;
+        mean /= n;
+        for (int k = 0; k < 5; ++k) variance += (pairs[k] + prior) * (k / 4.0 - mean) * (k / 4.0 - mean);
+        variance /= n;
+    }
+};
+
+double eloToScore(double elo) {
+    return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+}
+
+double scoreToElo(double score) {
+    score = max(1e-6, min(1.0 - 1e-6, score));
+    double elo = -400.0 * log10(1.0 / score - 1.0);
+    return elo == 0 ? 0 : elo; // Not -0
+}
+
+// Log-likelihood ratio of elo1 against elo0 for the pair results, by the
+// normal approximation of the generalized SPRT on the pentanomial counts.
+// A quarter of a pair is added to every count, so the variance is not zero
+// when all pairs end alike (one engine winning every game) and a few such
+// pairs are not enough to decide.
+double sprtLlr(const Tally &tally, double elo0, double elo1) {
+    const double prior = 0.25;
+    double mean, variance;
+    tally.pairScore(mean, variance, prior);
+    if (variance <= 0) return 0;
+    double s0 = eloToScore(elo0), s1 = eloToScore(elo1);
+    return (tally.pairCount() + 5 * prior) * (s1 - s0) * (2 * mean - s0 - s1) / (2 * variance);
+}
+
+void printTally(const TournamentOptions &opt, const Tally &tally) {
+    double mean, variance;
+    tally.pairScore(mean, variance);
+    long long n = tally.pairCount();
+    double margin = n > 0 ? 1.96 * sqrt(variance / n) : 0.5;
+    double elo = scoreToElo(mean);
+    cout << n * 2 << " games: +" << tally.wins << " =" << tally.draws << " -" << tally.losses
+         << ", score " << mean * 100 << "%, Elo " << elo << " +" << scoreToElo(mean + margin) - elo
+         << " -" << elo - scoreToElo(mean - margin);
+    if (opt.sprt) {
+        cout << ", LLR " << sprtLlr(tally, opt.elo0, opt.elo1) << " [" << log(opt.beta / (1 - opt.alpha)) << ", "
+             << log((1 - opt.beta) / opt.alpha) << "]";
+    }
+    cout << endl;
+}
+
+int main(int argc, char **argv) {
+    TournamentOptions opt;
+    string names[2] = {"bot", "sapfinal"};
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--no-sprt") {
+            opt.sprt = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cout << "Missing value for " << arg << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--engine1") names[0] = value;
+        else if (arg == "--engine2") names[1] = value;
+        else if (arg == "--games") opt.games = stoi(value);
+        else if (arg == "--threads") opt.threads = max(1, stoi(value));
+        else if (arg == "--rows") opt.rows = stoi(value);
+        else if (arg == "--cols") opt.cols = stoi(value);
+        else if (arg == "--win") opt.winLength = stoi(value);
+        else if (arg == "--opening") opt.openingMoves = stoi(value);
+        else if (arg == "--seed") opt.seed = stoul(value);
+        else if (arg == "--elo0") opt.elo0 = stod(value);
+        else if (arg == "--elo1") opt.elo1 = stod(value);
+        else if (arg == "--alpha") opt.alpha = stod(value);
+        else if (arg == "--beta") opt.beta = stod(value);
+        else {
+            cout << "Unknown option " << arg << endl;
+            return 1;
+        }
+    }
+    if (opt.winLength < MIN_WIN_LENGTH || opt.winLength > MAX_WIN_LENGTH || opt.rows < opt.winLength || opt.cols < opt.winLength) {
+        cout << "Need " << MIN_WIN_LENGTH << " <= k <= " << MAX_WIN_LENGTH << " and a board at least k x k" << endl;
+        return 1;
+    }
+    if (opt.openingMoves < 1 || opt.openingMoves > min(opt.rows, 7) * min(opt.cols, 7) / 2) {
+        cout << "The opening needs at least one stone and room for them near the center" << endl;
+        return 1;
+    }
+    for (int e = 0; e < 2; ++e) {
+        if (!parseEngine(names[e], opt.engines[e])) return 1;
+    }
+
+    int pairTotal = (opt.games + 1) / 2;
+    cout << opt.engines[0].name << " vs " << opt.engines[1].name << ", " << opt.rows << "x" << opt.cols << " k=" << opt.winLength
+         << ", up to " << pairTotal * 2 << " games on " << opt.threads << " threads" << endl;
+
+    Tally tally;
+    mutex tallyMutex;
+    atomic<int> nextPair(0);
+    atomic<bool> stop(false);
+    int verdict = 0; // 1: H1 accepted, -1: H0 accepted
+
+    auto worker = [&]() {
+        while (!stop) {
+            int index = nextPair++;
+            if (index >= pairTotal) break;
+            vector<pair<int, int>> opening = makeOpening(opt, opt.seed + index);
+
+            // Engine 1 plays O, then X
+            EngineStats stats[2];
+            char first = playGame(opt, opening, 0, stats);
+            char second = playGame(opt, opening, 1, stats);
+            int points = (first == 'O' ? 2 : first == 'D' ? 1 : 0) + (second == 'X' ? 2 : second == 'D' ? 1 : 0);
+
+            lock_guard<mutex> lock(tallyMutex);
+            if (stop) break; // Decided while this pair was played
+            for (char result : {first == 'O' ? 'W' : first == 'D' ? 'D' : 'L', second == 'X' ? 'W' : second == 'D' ? 'D' : 'L'}) {
+                if (result == 'W') tally.wins++;
+                else if (result == 'D') tally.draws++;
+                else tally.losses++;
+            }
+            tally.pairs[points]++;
+            for (int e = 0; e < 2; ++e) {
+                tally.stats[e].moves += stats[e].moves;
+                tally.stats[e].nodes += stats[e].nodes;
+                tally.stats[e].seconds += stats[e].seconds;
+            }
+            if (tally.pairCount() % 10 == 0) printTally(opt, tally);
+
+            if (opt.sprt) {
+                double llr = sprtLlr(tally, opt.elo0, opt.elo1);
+                if (llr >= log((1 - opt.beta) / opt.alpha)) verdict = 1;
+                if (llr <= log(opt.beta / (1 - opt.alpha))) verdict = -1;
+                if (verdict != 0) stop = true;
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 0; t < opt.threads; ++t) workers.emplace_back(worker);
+    for (auto &w : workers) w.join();
+
+    cout << "Final: ";
+    printTally(opt, tally);
+    cout << "Pairs by engine 1's points (0, 0.5, 1, 1.5, 2):";
+    for (long long count : tally.pairs) cout << " " << count;
+    cout << endl;
+    for (int e = 0; e < 2; ++e) {
+        const EngineStats &s = tally.stats[e];
+        long long moves = max(1LL, s.moves);
+        cout << opt.engines[e].name << ": " << s.moves << " moves, " << s.seconds * 1000 / moves << " ms and "
+             << s.nodes / moves << " nodes per move" << endl;
+    }
+    if (opt.sprt) {
+        if (verdict == 1) cout << "SPRT: H1 accepted, " << opt.engines[0].name << " is at least " << opt.elo1 << " Elo stronger" << endl;
+        else if (verdict == -1) cout << "SPRT: H0 accepted, " << opt.engines[0].name << " is at most " << opt.elo0 << " Elo stronger" << endl;
+        else cout << "SPRT: no decision after " << tally.pairCount() * 2 << " games" << endl;
+    }
+    return verdict == -1 ? 1 : 0;
+}
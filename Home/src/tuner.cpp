@@ -0,0 +1,328 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include "engine.h"
+#include "record.h"
+
+using namespace std;
+
+// Offline tuner for the bot's evaluation weights.
+// Plays self-play games on several threads, then fits EvalWeights with
+// Texel-style logistic regression: the evaluation of every recorded position,
+// squashed through a sigmoid, should predict the final result of its game.
+// Games can also be read from a record file instead of being played.
+//
+// Usage: tuner [--games N] [--threads N] [--depth N] [--rows N] [--cols N]
+//              [--epochs N] [--seed N] [--in weights.txt] [--out weights.txt]
+//              [--record games.ttr] [--games-file games.ttr]
+
+const int NUM_PARAMS = 2 * PATTERN_COUNT + 1;
+
+struct TunerOptions {
+    int games = 200;
+    int threads = max(1u, thread::hardware_concurrency());
+    int depth = 1;
+    int rows = 10, cols = 10;
+    int openingMoves = 4;
+    int epochs = 500;
+    unsigned seed = 1;
+    string inPath;
+    string outPath = "weights.txt";
+    string recordPath;     // Write self-play games here
+    string gamesPath;      // Train on these games instead of self-play
+};
+
+// One training position seen from one side
+struct Sample {
+    double features[NUM_PARAMS];
+    double result; // 1 = win, 0.5 = draw, 0 = loss for that side
+};
+
+// Parameter vector layout: own patterns, opponent patterns, center weight
+void weightsToParams(const EvalWeights &w, double *params) {
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        params[p] = w.own[p];
+        params[PATTERN_COUNT + p] = w.opp[p];
+    }
+    params[2 * PATTERN_COUNT] = w.center;
+}
+
+EvalWeights paramsToWeights(const double *params) {
+    EvalWeights w;
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        w.own[p] = (int)lround(params[p]);
+        w.opp[p] = (int)lround(params[PATTERN_COUNT + p]);
+    }
+    w.center = (int)lround(params[2 * PATTERN_COUNT]);
+    return w;
+}
+
+// Features such that BotManager's evaluation equals dot(params, features)
+Sample makeSample(const EvalFeatures &f, double result) {
+    Sample s;
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        s.features[p] = f.own[p];
+        s.features[PATTERN_COUNT + p] = -EvalWeights::OPPONENT_SCALE * f.opp[p];
+    }
+    s.features[2 * PATTERN_COUNT] = f.ownCenter - EvalWeights::OPPONENT_SCALE * f.oppCenter;
+    s.result = result;
+    return s;
+}
+
+double evaluateSample(const Sample &s, const double *params) {
+    double eval = 0;
+    for (int i = 0; i < NUM_PARAMS; ++i) eval += params[i] * s.features[i];
+    return eval;
+}
+
+double sigmoid(double x) {
+    return 1.0 / (1.0 + exp(-x));
+}
+
+// Turn a finished game into samples from both sides' point of view.
+// The opening and the final (already decided) position are skipped.
+void addGameSamples(const GameRecord &game, int openingMoves, vector<Sample> &out) {
+    Grid grid(game.header.rows, game.header.cols, game.header.winLength);
+    BotManager botO(grid, 'O'), botX(grid, 'X');
+    double resultO = (game.result == 'O') ? 1.0 : (game.result == 'X') ? 0.0 : 0.5;
+    char player = 'O';
+
+    for (size_t i = 0; i + 1 < game.moves.size(); ++i) {
+        grid.makeMove(game.moves[i].row, game.moves[i].col, player);
+        player = (player == 'O') ? 'X' : 'O';
+        if ((int)i + 1 < openingMoves) continue;
+
+        out.push_back(makeSample(botO.extractFeatures(), resultO));
+        out.push_back(makeSample(botX.extractFeatures(), 1.0 - resultO));
+    }
+}
+
+// Play one self-play game with a random opening
+GameRecord playGame(const TunerOptions &opt, const EvalWeights &weights, unsigned seed) {
+    Grid grid(opt.rows, opt.cols);
+    GameLogic gameLogic(grid);
+    BotManager botO(grid, 'O', weights), botX(grid, 'X', weights);
+    botO.setSearchDepth(opt.depth);
+    botX.setSearchDepth(opt.depth);
+    botO.setVerbose(false);
+    botX.setVerbose(false);
+
+    mt19937 rng(seed);
+    PlayerManager playerManager;
+    // Self-play is untimed
+    GameRecord game = {{opt.rows, opt.cols, TimeControl::perMove(0), PLAYER_O_BOT | PLAYER_X_BOT, FLAG_STATS, grid.getWinLength()}, {}, 'D'};
+
+    for (int move = 0; move < opt.rows * opt.cols; ++move) {
+        char player = playerManager.getCurrentPlayer();
+        MoveRecord record = {-1, -1, 0, 0};
+
+        if (move < opt.openingMoves) {
+            // Random opening near the center so games differ
+            uniform_int_distribution<int> offset(-2, 2);
+            do {
+                record.row = opt.rows / 2 + offset(rng);
+                record.col = opt.cols / 2 + offset(rng);
+            } while (!grid.isCellEmpty(record.row, record.col));
+            grid.makeMove(record.row, record.col, player);
+        } else {
+            BotManager &bot = (player == 'O') ? botO : botX;
+            auto start = chrono::steady_clock::now();
+            bot.makeMove();
+            record.searchMicros = (uint32_t)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+            record.nodes = bot.getLastNodes();
+            record.row = bot.getLastRow();
+            record.col = bot.getLastCol();
+            if (record.row == -1) break;
+        }
+        game.moves.push_back(record);
+
+        if (gameLogic.checkWinner(record.row, record.col).hasWinner) {
+            game.result = player;
+            break;
+        }
+        if (grid.isFull()) break;
+        playerManager.switchPlayer();
+    }
+
+    return game;
+}
+
+// Mean squared error of the sigmoid prediction and its gradient, split over threads
+double computeError(const vector<Sample> &samples, const double *params, double k, int threads, double *gradient) {
+    vector<double> errors(threads, 0.0);
+    vector<vector<double>> gradients(threads, vector<double>(NUM_PARAMS, 0.0));
+    vector<thread> workers;
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = t; i < samples.size(); i += threads) {
+                const Sample &s = samples[i];
+                double predicted = sigmoid(k * evaluateSample(s, params));
+                double diff = predicted - s.result;
+                errors[t] += diff * diff;
+                if (gradient) {
+                    double scale = 2.0 * diff * predicted * (1.0 - predicted) * k;
+                    for (int j = 0; j < NUM_PARAMS; ++j) gradients[t][j] += scale * s.features[j];
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+
+    double error = 0;
+    for (int t = 0; t < threads; ++t) error += errors[t];
+    if (gradient) {
+        for (int j = 0; j < NUM_PARAMS; ++j) {
+            gradient[j] = 0;
+            for (int t = 0; t < threads; ++t) gradient[j] += gradients[t][j];
+            gradient[j] /= samples.size();
+        }
+    }
+    return error / samples.size();
+}
+
+// Find the sigmoid scale that best fits the starting weights
+double fitScale(const vector<Sample> &samples, const double *params, int threads) {
+    double lo = -4.5, hi = -1; // log10 of the scale; bounded below so the gradient cannot vanish
+    for (int i = 0; i < 40; ++i) {
+        double m1 = lo + (hi - lo) / 3, m2 = hi - (hi - lo) / 3;
+        if (computeError(samples, params, pow(10, m1), threads, nullptr) <
+            computeError(samples, params, pow(10, m2), threads, nullptr)) {
+            hi = m2;
+        } else {
+            lo = m1;
+        }
+    }
+    return pow(10, (lo + hi) / 2);
+}
+
+bool parseOptions(int argc, char **argv, TunerOptions &opt) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cout << "Missing value for " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+        if (arg == "--games") opt.games = stoi(value);
+        else if (arg == "--threads") opt.threads = max(1, stoi(value));
+        else if (arg == "--depth") opt.depth = stoi(value);
+        else if (arg == "--rows") opt.rows = stoi(value);
+        else if (arg == "--cols") opt.cols = stoi(value);
+        else if (arg == "--epochs") opt.epochs = stoi(value);
+        else if (arg == "--seed") opt.seed = stoul(value);
+        else if (arg == "--in") opt.inPath = value;
+        else if (arg == "--out") opt.outPath = value;
+        else if (arg == "--record") opt.recordPath = value;
+        else if (arg == "--games-file") opt.gamesPath = value;
+        else {
+            cout << "Unknown option " << arg << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    TunerOptions opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+
+    EvalWeights weights = EvalWeights::defaults();
+    if (!opt.inPath.empty() && !weights.load(opt.inPath)) {
+        cout << "Could not read " << opt.inPath << endl;
+        return 1;
+    }
+
+    // Phase 1: collect games, from a record file or from self-play on every thread
+    vector<GameRecord> games;
+    if (!opt.gamesPath.empty()) {
+        GameRecordReader reader;
+        if (!reader.open(opt.gamesPath)) {
+            cout << "Could not read " << opt.gamesPath << endl;
+            return 1;
+        }
+        GameRecord game;
+        while (reader.readGame(game)) games.push_back(game);
+        cout << "Read " << games.size() << " games from " << opt.gamesPath << endl;
+    } else {
+        cout << "Playing " << opt.games << " games on " << opt.threads << " threads..." << endl;
+        games.resize(opt.games);
+        GameRecordWriter recorder;
+        if (!opt.recordPath.empty() && !recorder.open(opt.recordPath)) {
+            cout << "Could not write " << opt.recordPath << endl;
+            return 1;
+        }
+        mutex recorderMutex;
+        vector<thread> workers;
+        for (int t = 0; t < opt.threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (int g = t; g < opt.games; g += opt.threads) {
+                    games[g] = playGame(opt, weights, opt.seed * 7919 + g);
+                    if (recorder.isOpen()) {
+                        lock_guard<mutex> lock(recorderMutex);
+                        recorder.writeGame(games[g]);
+                    }
+                }
+            });
+        }
+        for (auto &worker : workers) worker.join();
+    }
+
+    // Phase 2: turn positions into samples, one batch per thread
+    vector<vector<Sample>> batches(opt.threads);
+    vector<thread> workers;
+    for (int t = 0; t < opt.threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (size_t g = t; g < games.size(); g += opt.threads) {
+                addGameSamples(games[g], opt.openingMoves, batches[t]);
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+
+    vector<Sample> samples;
+    for (auto &batch : batches) samples.insert(samples.end(), batch.begin(), batch.end());
+    if (samples.empty()) {
+        cout << "No positions recorded." << endl;
+        return 1;
+    }
+    cout << "Recorded " << samples.size() << " samples." << endl;
+
+    // Phase 3: logistic regression with Adam
+    double params[NUM_PARAMS], gradient[NUM_PARAMS];
+    double moment[NUM_PARAMS] = {}, velocity[NUM_PARAMS] = {}, stepSize[NUM_PARAMS];
+    weightsToParams(weights, params);
+    for (int j = 0; j < NUM_PARAMS; ++j) stepSize[j] = 0.01 * max(fabs(params[j]), 1.0);
+
+    double k = fitScale(samples, params, opt.threads);
+    double startError = computeError(samples, params, k, opt.threads, nullptr);
+    cout << "Sigmoid scale " << k << ", starting error " << startError << endl;
+
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-12;
+    double error = startError;
+    for (int epoch = 1; epoch <= opt.epochs; ++epoch) {
+        error = computeError(samples, params, k, opt.threads, gradient);
+        for (int j = 0; j < NUM_PARAMS; ++j) {
+            moment[j] = beta1 * moment[j] + (1 - beta1) * gradient[j];
+            velocity[j] = beta2 * velocity[j] + (1 - beta2) * gradient[j] * gradient[j];
+            double m = moment[j] / (1 - pow(beta1, epoch));
+            double v = velocity[j] / (1 - pow(beta2, epoch));
+            params[j] -= stepSize[j] * m / (sqrt(v) + epsilon);
+        }
+        if (epoch % 100 == 0) cout << "Epoch " << epoch << ": error " << error << endl;
+    }
+
+    EvalWeights tuned = paramsToWeights(params);
+    if (!tuned.save(opt.outPath)) {
+        cout << "Could not write " << opt.outPath << endl;
+        return 1;
+    }
+    cout << "Error " << startError << " -> " << error << ", weights written to " << opt.outPath << endl;
+    return 0;
+}
@@ -0,0 +1,329 @@
+#ifndef VIEWS_H
+#define VIEWS_H
+
+// The game's screens, drawn through a Renderer so they do not depend on
+// graphics.h: the GUI shows them in its window, headless tools draw them
+// into a SoftwareRenderer (see screenshot.cpp).
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "engine.h"
+#include "infinite.h"
+#include "render.h"
+
+const int CELL_SIZE = 40;     // Largest cell of a bounded grid
+const int MIN_CELL_SIZE = 16; // Cells shrink down to this to fit the window
+const int BUTTON_WIDTH = 150;
+const int BUTTON_HEIGHT = 50;
+const int MENU_WIDTH = 800;   // Menus are laid out for 800x600 and centered in larger windows
+const int MENU_HEIGHT = 600;
+
+// Top of the menu area in the middle of the screen
+inline int menuTop(const Renderer &screen) {
+    return std::max(0, (screen.getHeight() - MENU_HEIGHT) / 2);
+}
+
+// Largest text size up to size at which s fits in maxWidth pixels
+inline int fitTextSize(const Renderer &screen, const std::string &s, int maxWidth, int size) {
+    while (size > 1 && screen.textWidth(s, size) > maxWidth) size--;
+    return size;
+}
+
+// Player names at the top of a game screen
+inline void drawPlayerNames(Renderer &screen, const std::string &player1Name, const std::string &player2Name) {
+    screen.text(20, 10, "Player 1: " + player1Name + " (O)", PIXEL_WHITE, 2);
+    screen.text(20, 50, "Player 2: " + player2Name + " (X)", PIXEL_WHITE, 2);
+}
+
+// Timer text with its right edge 20 pixels from the window's, over a cleared background
+inline void drawTimer(Renderer &screen, const std::string &timerText, int y) {
+    int width = screen.textWidth(timerText, 2);
+    screen.bar(screen.getMaxX() - width - 60, y, screen.getMaxX() - 20, y + screen.textHeight(2) - 1, PIXEL_BLACK);
+    screen.text(screen.getMaxX() - width - 20, y, timerText, PIXEL_WHITE, 2);
+}
+
+// Winner or draw message in the middle of the screen
+inline void drawCenteredMessage(Renderer &screen, const std::string &message) {
+    int size = fitTextSize(screen, message, screen.getWidth() - 20, 3);
+    int x = (screen.getMaxX() - screen.textWidth(message, size)) / 2;
+    int y = (screen.getMaxY() - screen.textHeight(size)) / 2;
+    screen.text(x, y, message, PIXEL_YELLOW, size);
+}
+
+// Class to draw the grid. The cells are as large as fits the screen, up to
+// CELL_SIZE, leaving room for the names above and the hints and timer below;
+// the grid is centered horizontally.
+class GridView {
+private:
+    Grid &grid;
+    Renderer &screen;
+    int cellSize;
+    int offsetX;             // Horizontal offset
+    const int offsetY = 100; // Vertical offset for player names
+
+public:
+    GridView(Grid &g, Renderer &r) : grid(g), screen(r) {
+        int fitWidth = (screen.getWidth() - 40) / grid.getCols();
+        int fitHeight = (screen.getHeight() - offsetY - 90) / grid.getRows();
+        cellSize = std::max(MIN_CELL_SIZE, std::min(CELL_SIZE, std::min(fitWidth, fitHeight)));
+        offsetX = std::max(0, (screen.getWidth() - grid.getCols() * cellSize) / 2);
+    }
+
+    // Grid cell under a screen position; false outside the grid
+    bool cellAt(int x, int y, int &row, int &col) const {
+        if (x < offsetX || y < offsetY || x >= offsetX + grid.getCols() * cellSize || y >= offsetY + grid.getRows() * cellSize) return false;
+        row = (y - offsetY) / cellSize;
+        col = (x - offsetX) / cellSize;
+        return true;
+    }
+
+    void drawWinningLine(int startRow, int startCol, int endRow, int endCol) {
+        int startX = offsetX + startCol * cellSize + cellSize / 2;
+        int startY = offsetY + startRow * cellSize + cellSize / 2;
+        int endX = offsetX + endCol * cellSize + cellSize / 2;
+        int endY = offsetY + endRow * cellSize + cellSize / 2;
+        screen.line(startX, startY, endX, endY, PIXEL_RED, 3); // Thick red line
+    }
+
+    void drawGrid() {
+        int rows = grid.getRows(), cols = grid.getCols();
+        for (int i = 0; i <= cols; ++i) {
+            screen.line(offsetX + i * cellSize, offsetY, offsetX + i * cellSize, offsetY + rows * cellSize, PIXEL_WHITE);
+        }
+        for (int i = 0; i <= rows; ++i) {
+            screen.line(offsetX, offsetY + i * cellSize, offsetX + cols * cellSize, offsetY + i * cellSize, PIXEL_WHITE);
+        }
+        drawSymbols();
+    }
+
+    void drawSymbols() {
+        for (int i = 0; i < grid.getRows(); ++i) {
+            for (int j = 0; j < grid.getCols(); ++j) {
+                if (!grid.isCellEmpty(i, j)) {
+                    drawSymbol(i, j, grid.getCell(i, j));
+                }
+            }
+        }
+    }
+
+    void drawSymbol(int row, int col, char symbol) {
+        std::string sym(1, symbol);
+        int size = cellSize >= 32 ? 2 : 1;
+        int x = offsetX + col * cellSize + (cellSize - screen.textWidth(sym, size)) / 2;
+        int y = offsetY + row * cellSize + (cellSize - screen.textHeight(size)) / 2;
+        screen.text(x, y, sym, symbol == 'O' ? PIXEL_LIGHTCYAN : PIXEL_RED, size);
+    }
+
+    // Number the hinted cells and list the moves with their scores below the grid
+    void drawHints(const std::vector<AnalysisLine> &hints) {
+        int textY = offsetY + grid.getRows() * cellSize + 10;
+        for (size_t i = 0; i < hints.size(); ++i) {
+            const AnalysisLine &hint = hints[i];
+            std::string rank = std::to_string(i + 1);
+            screen.text(offsetX + hint.col * cellSize + 4, offsetY + hint.row * cellSize + 4, rank, PIXEL_YELLOW, 1);
+
+            std::string score = BotManager::isWinScore(hint.score) ? (hint.score > 0 ? "win" : "loss") : std::to_string(hint.score);
+            std::string text = rank + ": (" + std::to_string(hint.row) + ", " + std::to_string(hint.col) + ") " + score;
+            screen.text(offsetX + (int)i * 140, textY, text, PIXEL_YELLOW, 1);
+        }
+    }
+};
+
+// Class to draw a window onto a SparseBoard, filling the screen below the
+// names. Arrow keys or WASD scroll it, + and - zoom; the viewport follows
+// moves that land outside it.
+class InfiniteView {
+private:
+    SparseBoard &board;
+    Renderer &screen;
+    int topRow, leftCol; // Board cell in the top-left corner
+    int cellSize;
+    const int offsetX = 20;
+    const int offsetY = 100;
+    const int viewWidth;
+    const int viewHeight;
+
+    int visibleRows() const { return viewHeight / cellSize; }
+    int visibleCols() const { return viewWidth / cellSize; }
+
+public:
+    InfiniteView(SparseBoard &b, Renderer &r)
+        : board(b), screen(r), cellSize(CELL_SIZE), viewWidth(r.getWidth() - 40), viewHeight(r.getHeight() - 160) {
+        centerOn(0, 0);
+    }
+
+    void centerOn(int row, int col) {
+        topRow = row - visibleRows() / 2;
+        leftCol = col - visibleCols() / 2;
+    }
+
+    void scroll(int rows, int cols) {
+        topRow += rows;
+        leftCol += cols;
+    }
+
+    // Change the cell size, keeping the middle of the view in place
+    void zoom(int step) {
+        int midRow = topRow + visibleRows() / 2, midCol = leftCol + visibleCols() / 2;
+        cellSize = std::max(16, std::min(64, cellSize + step));
+        centerOn(midRow, midCol);
+    }
+
+    // Bring a cell into view if it is outside
+    void follow(int row, int col) {
+        if (row < topRow || row >= topRow + visibleRows() || col < leftCol || col >= leftCol + visibleCols()) centerOn(row, col);
+    }
+
+    // Board cell under a screen position; false outside the view
+    bool cellAt(int x, int y, int &row, int &col) const {
+        if (x < offsetX || y < offsetY || x >= offsetX + visibleCols() * cellSize || y >= offsetY + visibleRows() * cellSize) return false;
+        row = topRow + (y - offsetY) / cellSize;
+        col = leftCol + (x - offsetX) / cellSize;
+        return true;
+    }
+
+    void draw() {
+        int rows = visibleRows(), cols = visibleCols();
+        for (int i = 0; i <= cols; ++i) {
+            screen.line(offsetX + i * cellSize, offsetY, offsetX + i * cellSize, offsetY + rows * cellSize, PIXEL_DARKGRAY);
+        }
+        for (int i = 0; i <= rows; ++i) {
+            screen.line(offsetX, offsetY + i * cellSize, offsetX + cols * cellSize, offsetY + i * cellSize, PIXEL_DARKGRAY);
+        }
+
+        int size = cellSize >= 32 ? 2 : 1;
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                char symbol = board.getCell(topRow + r, leftCol + c);
+                if (symbol == ' ') continue;
+                std::string sym(1, symbol);
+                int x = offsetX + c * cellSize + (cellSize - screen.textWidth(sym, size)) / 2;
+                int y = offsetY + r * cellSize + (cellSize - screen.textHeight(size)) / 2;
+                screen.text(x, y, sym, symbol == 'O' ? PIXEL_LIGHTCYAN : PIXEL_RED, size);
+            }
+        }
+
+        std::string position = "View at (" + std::to_string(topRow) + ", " + std::to_string(leftCol) + ")  arrows/WASD: scroll  +/-: zoom";
+        screen.text(offsetX, offsetY + viewHeight + 10, position, PIXEL_WHITE, 1);
+    }
+
+    void drawWinningLine(const WinSequence &win) {
+        int startX = offsetX + (win.startCol - leftCol) * cellSize + cellSize / 2;
+        int startY = offsetY + (win.startRow - topRow) * cellSize + cellSize / 2;
+        int endX = offsetX + (win.endCol - leftCol) * cellSize + cellSize / 2;
+        int endY = offsetY + (win.endRow - topRow) * cellSize + cellSize / 2;
+        screen.line(startX, startY, endX, endY, PIXEL_RED, 3);
+    }
+};
+
+// Class to manage the game menu
+class GameMenu {
+public:
+    static void drawGameModeMenu(Renderer &screen) {
+        screen.clear();
+        int centerX = screen.getMaxX() / 2;
+        int top = menuTop(screen);
+
+        // Draw buttons for game modes, one per bot level
+        drawButton(screen, centerX - BUTTON_WIDTH / 2, top + 200, "Player vs Player");
+        std::string caption = "Player vs Bot";
+        screen.text(centerX - screen.textWidth(caption, 2) / 2, top + 300, caption, PIXEL_WHITE, 2);
+        for (int level = 0; level < BOT_LEVEL_COUNT; ++level) {
+            drawButton(screen, levelButtonX(centerX, level), top + 340, BOT_LEVELS[level].name);
+        }
+    }
+
+    // Left edge of the button of a bot level, the buttons centered in a row
+    static int levelButtonX(int centerX, int level) {
+        int rowWidth = BOT_LEVEL_COUNT * (BUTTON_WIDTH + 20) - 20;
+        return centerX - rowWidth / 2 + level * (BUTTON_WIDTH + 20);
+    }
+
+    static void drawMenu(Renderer &screen, int rows, int cols, int winLength) {
+        int centerX = screen.getMaxX() / 2;
+        int centerY = screen.getMaxY() / 2;
+
+        // Draw rows and columns text
+        std::string rowText = "Rows: " + std::to_string(rows);
+        std::string colText = "Cols: " + std::to_string(cols);
+        screen.text(centerX - screen.textWidth(rowText, 2) / 2, centerY - 120, rowText, PIXEL_WHITE, 2);
+        screen.text(centerX - screen.textWidth(colText, 2) / 2, centerY - 70, colText, PIXEL_WHITE, 2);
+
+        // Win length button, cycles through the supported lengths
+        std::string winText = std::to_string(winLength) + " in a row";
+        drawButton(screen, centerX - BUTTON_WIDTH / 2, centerY - 200, winText);
+
+        // Recalculate positions
+        int leftX = centerX - BUTTON_WIDTH - 40;  // Left side for Rows
+        int rightX = centerX + 40;               // Right side for Cols
+
+        // Buttons for Rows
+        drawButton(screen, leftX, centerY - 40, "Rows +"); // Top left
+        drawButton(screen, leftX, centerY + 40, "Rows -"); // Bottom left
+
+        // Buttons for Cols
+        drawButton(screen, rightX, centerY - 40, "Cols +"); // Top right
+        drawButton(screen, rightX, centerY + 40, "Cols -"); // Bottom right
+
+        // Start Game button
+        drawButton(screen, centerX - BUTTON_WIDTH / 2, centerY + 150, "Start Game");
+        drawButton(screen, centerX - BUTTON_WIDTH / 2, centerY + 220, "No Edges"); // Unbounded board
+    }
+
+    // Labels too wide for the button at size 2 drop to size 1
+    static void drawButton(Renderer &screen, int x, int y, const std::string &label) {
+        screen.bar(x, y, x + BUTTON_WIDTH, y + BUTTON_HEIGHT, PIXEL_BLACK);
+        screen.rectangle(x, y, x + BUTTON_WIDTH, y + BUTTON_HEIGHT, PIXEL_WHITE);
+        int size = fitTextSize(screen, label, BUTTON_WIDTH - 8, 2);
+        int textWidth = screen.textWidth(label, size);
+        int textHeight = screen.textHeight(size);
+        screen.text(x + (BUTTON_WIDTH - textWidth) / 2, y + (BUTTON_HEIGHT - textHeight) / 2, label, PIXEL_WHITE, size);
+    }
+
+    static void drawTimerMenu(Renderer &screen) {
+        int centerX = screen.getMaxX() / 2;
+        int top = menuTop(screen);
+
+        // Draw buttons for timer options: a limit per move...
+        screen.text(centerX - screen.textWidth("Per move", 1) / 2, top + 175, "Per move", PIXEL_WHITE, 1);
+        drawButton(screen, centerX - BUTTON_WIDTH, top + 200, "10 Seconds");
+        drawButton(screen, centerX + 10, top + 200, "30 Seconds");
+        drawButton(screen, centerX - BUTTON_WIDTH / 2, top + 300, "60 Seconds");
+
+        // ...or a clock per player for the whole game
+        screen.text(centerX - screen.textWidth("Per game", 1) / 2, top + 405, "Per game", PIXEL_WHITE, 1);
+        drawButton(screen, centerX - BUTTON_WIDTH * 3 / 2 - 20, top + 430, "5 min");
+        drawButton(screen, centerX - BUTTON_WIDTH / 2, top + 430, "3 min + 2s");
+        drawButton(screen, centerX + BUTTON_WIDTH / 2 + 20, top + 430, "1 min + 3x10s");
+
+        // Add a title
+        std::string title = "Select Timer Mode";
+        screen.text(centerX - screen.textWidth(title, 3) / 2, top + 100, title, PIXEL_WHITE, 3);
+    }
+
+    static void drawNameInputMenu(Renderer &screen, const std::string &player1Name, const std::string &player2Name, int currentName, bool vsBot) {
+        screen.clear();
+        int centerX = screen.getMaxX() / 2;
+        int top = menuTop(screen);
+
+        // Display current name being edited
+        std::string promptText = (currentName == 1) ? "Enter Player 1's Name(5 characters only):" : (vsBot ? "Bot's Name: Bot" : "Enter Player 2's Name(5 characters only):");
+        int promptSize = fitTextSize(screen, promptText, screen.getWidth() - 40, 2);
+        screen.text(centerX - screen.textWidth(promptText, promptSize) / 2, top + 100, promptText, PIXEL_WHITE, promptSize);
+
+        // Show names entered so far
+        std::string player1Text = "Player 1: " + player1Name;
+        std::string player2Text = vsBot ? "Player 2: Bot" : "Player 2: " + player2Name;
+
+        screen.text(centerX - 200, top + 200, player1Text, PIXEL_WHITE, 2);
+        screen.text(centerX - 200, top + 250, player2Text, PIXEL_WHITE, 2);
+
+        // Instructions
+        std::string instructionText = "Type the name and press ENTER to continue.";
+        int instructionSize = fitTextSize(screen, instructionText, screen.getWidth() - 40, 2);
+        screen.text(centerX - screen.textWidth(instructionText, instructionSize) / 2, top + 400, instructionText, PIXEL_WHITE, instructionSize);
+    }
+};
+
+#endif